@@ -1,16 +1,16 @@
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <cstring>
 
-#include <point.hpp>
-#include <polygon.hpp>
-#include <queue.hpp>
-#include <allocator.hpp>
-
-using rhombus = basic_polygon<point2d, 4>;
+#include <repl.hpp>
 
 auto constexpr prompt = "~> ";
 
-void read_rhombus(std::istream& in, rhombus& r);
+/*!
+ * @brief shapes the queues can hold, set at build time with the POOL_SIZE cache variable
+ */
+auto constexpr pool_size = OOP_POOL_SIZE;
 
 struct print_string_at_loop_end
 {
@@ -22,126 +22,107 @@ struct print_string_at_loop_end
     }
 };
 
+/*!
+ * @brief parses a non-negative integer option value, rejects trailing garbage and signs
+ */
+unsigned long parse_number(const char* option, const char* value)
+{
+    size_t used = 0;
+    unsigned long result = 0;
+    try
+    {
+        result = std::stoul(value, &used);
+    }
+    catch (const std::exception&)
+    {
+        used = 0;
+    }
+    if (used == 0 || value[used] != '\0' || value[0] == '-')
+    {
+        throw std::invalid_argument{ std::string{ "bad value for " } + option + ": '" + value + "'" };
+    }
+    return result;
+}
+
 int main(const int argc, char* argv[])
 {
-    oop::queue<rhombus, oop::vector_allocator<rhombus, 0x10>> q;
+    oop::basic_repl<pool_size> repl{ std::cin, std::cout };
+    oop::journal_options       journal_options;
+    std::string                journal_path;
+    std::string                stats_path;
+    std::chrono::seconds       stats_interval{ 10 };
+    size_t                     threads = 0;
 
-    std::cout << prompt;
-    std::string input;
-    while (std::cin >> input)
+    try
     {
-        print_string_at_loop_end printer{ prompt };
-
-        try {
-            if (input == "push")
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* option    = argv[i];
+            const bool  has_value = i + 1 < argc;
+            if (std::strcmp(option, "--journal-sync-ms") == 0 && has_value)
             {
-                rhombus r;
-                read_rhombus(std::cin, r);
-                q.push(r);
+                journal_options.max_delay = std::chrono::milliseconds{ parse_number(option, argv[++i]) };
             }
-            else if (input == "top")
+            else if (std::strcmp(option, "--journal-sync-bytes") == 0 && has_value)
             {
-                rhombus& r = q.top();
-                print2d(std::cout, r);
+                journal_options.max_bytes = parse_number(option, argv[++i]);
             }
-            else if (input == "pop")
+            else if (std::strcmp(option, "--journal") == 0 && has_value)
             {
-                q.pop();
+                journal_path = argv[++i];
             }
-            else if (input == "insert")
+            else if (std::strcmp(option, "--stats-interval") == 0 && has_value)
             {
-                size_t ix;
-                rhombus r;
-                std::cin >> ix;
-                read_rhombus(std::cin, r);
-
-                auto it = q.begin();
-                while (ix > 0)
-                {
-                    ++it;
-                    --ix;
-                }
-                q.insert(it, r);
+                stats_interval = std::chrono::seconds{ parse_number(option, argv[++i]) };
             }
-            else if (input == "erase")
+            else if (std::strcmp(option, "--stats-file") == 0 && has_value)
             {
-                size_t ix;
-                std::cin >> ix;
-
-                auto it = q.begin();
-                while (ix > 0)
-                {
-                    ++it;
-                    --ix;
-                }
-                q.erase(it);
+                stats_path = argv[++i];
             }
-            else if (input == "print")
+            else if (std::strcmp(option, "--threads") == 0 && has_value)
             {
-                size_t i = 0;
-                std::for_each(q.begin(), q.end(),
-                    [&i](rhombus& r)
-                    {
-                        std::cout << "[-- " << i << " --]\n\n";
-                        print2d(std::cout, r);
-                        ++i;
-                    }
-                );
+                threads = parse_number(option, argv[++i]);
             }
-            else if (input == "less")
+            else
             {
-                double area;
-                std::cin >> area;
-                if (area < 0)
-                {
-                    std::cout << "invalid area" << std::endl;
-                    continue;
-                }
-
-                for (auto& r : q)
-                {
-                    if (area2d(r) < area)
-                    {
-                        print2d(std::cout, r);
-                    }
-                }
+                std::cerr << "usage: " << argv[0]
+                    << " [--journal <path>] [--journal-sync-ms <ms>] [--journal-sync-bytes <bytes>]"
+                       " [--stats-file <path>] [--stats-interval <s>] [--threads <n>]" << std::endl;
+                return 1;
             }
-            else if (input == "exit")
+        }
+
+        repl.set_threads(threads);
+        if (!journal_path.empty())
+        {
+            try
             {
-                break;
+                repl.open_journal(journal_path, journal_options);
             }
-            else
+            catch (const std::exception& e)
             {
-                std::cout << "Unknown command '" << input << "'" << std::endl;
+                throw std::runtime_error{ "can not replay journal " + journal_path + ": " + e.what() };
             }
         }
-        catch (std::exception & e)
+        if (!stats_path.empty())
         {
-            std::cout << "error: " << e.what() << std::endl;
+            repl.dump_stats(stats_path, stats_interval);
         }
     }
-}
-
-void read_rhombus(std::istream& in, rhombus& r)
-{
-    auto constexpr precision = 0.000000001L;
-    for (auto& p : r)
-    {
-        in >> p;
-    }
-    if (in.fail())
+    catch (const std::exception& e)
     {
-        return;
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 1;
     }
 
-    constexpr size_t size = rhombus::size();
-    const double dist = distance(r[0], r[size - 1]);
-    for (size_t i = 0; i < size - 1; i++)
+    std::cout << prompt;
+    std::string input;
+    while (std::cin >> input)
     {
-        const double next = distance(r[i], r[i + 1]);
-        if (std::abs(dist - next) > precision)
+        print_string_at_loop_end printer{ prompt };
+
+        if (!repl.execute(input))
         {
-            in.setstate(std::ios::failbit);
             break;
         }
     }
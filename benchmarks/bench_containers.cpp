@@ -0,0 +1,181 @@
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include <allocator.hpp>
+#include <queue.hpp>
+#include <priority_queue.hpp>
+
+namespace
+{
+    auto constexpr pool_size = 1 << 16;
+    auto constexpr min_size  = 1 << 4;
+    auto constexpr max_size  = 1 << 12;
+
+    template <typename T>
+    using pool_allocator = oop::vector_allocator<T, pool_size>;
+
+    // push/pop churn: keep `size` elements alive and cycle one element through the container
+
+    template <typename Allocator>
+    void list_churn(benchmark::State& state)
+    {
+        std::list<int, Allocator> list;
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            list.push_back(i);
+        }
+        for (auto _ : state)
+        {
+            list.push_back(0);
+            list.pop_front();
+            benchmark::DoNotOptimize(list.front());
+        }
+    }
+
+    template <typename Allocator>
+    void map_churn(benchmark::State& state)
+    {
+        std::map<int, int, std::less<>, Allocator> map;
+        int next = 0;
+        for (; next < state.range(0); ++next)
+        {
+            map.emplace(next, next);
+        }
+        for (auto _ : state)
+        {
+            map.emplace(next, next);
+            map.erase(map.begin());
+            ++next;
+            benchmark::DoNotOptimize(map.size());
+        }
+    }
+
+    template <typename Allocator>
+    void queue_churn(benchmark::State& state)
+    {
+        oop::queue<int, Allocator> q;
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            q.push(i);
+        }
+        for (auto _ : state)
+        {
+            q.push(0);
+            q.pop();
+            benchmark::DoNotOptimize(q.top());
+        }
+    }
+
+    struct identity
+    {
+        int operator()(int v) const noexcept
+        {
+            return v;
+        }
+    };
+
+    template <typename Allocator>
+    void priority_queue_churn(benchmark::State& state)
+    {
+        oop::priority_queue<int, identity, std::less<>, 4, Allocator> q;
+        int next = 0;
+        for (; next < state.range(0); ++next)
+        {
+            q.push((next * 7919) % 10007);
+        }
+        for (auto _ : state)
+        {
+            q.push((next++ * 7919) % 10007);
+            q.pop();
+            benchmark::DoNotOptimize(q.top());
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    // iteration
+
+    template <typename Allocator>
+    void queue_iterate(benchmark::State& state)
+    {
+        oop::queue<int, Allocator> q;
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            q.push(i);
+        }
+        for (auto _ : state)
+        {
+            long sum = 0;
+            for (auto& v : q)
+            {
+                sum += v;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Allocator>
+    void queue_end(benchmark::State& state)
+    {
+        oop::queue<int, Allocator> q;
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            q.push(i);
+        }
+        for (auto _ : state)
+        {
+            auto it = q.end();
+            benchmark::DoNotOptimize(it);
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    // insert/erase by index: walk to the middle, then mutate
+
+    template <typename Allocator>
+    void queue_insert_erase_middle(benchmark::State& state)
+    {
+        oop::queue<int, Allocator> q;
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            q.push(i);
+        }
+        const auto middle = state.range(0) / 2;
+        for (auto _ : state)
+        {
+            auto it = q.begin();
+            for (auto i = 0; i < middle; ++i)
+            {
+                ++it;
+            }
+            q.insert(it, 0);
+            q.erase(it);
+        }
+        state.SetComplexityN(state.range(0));
+    }
+}
+
+BENCHMARK_TEMPLATE(list_churn, std::allocator<int>)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(list_churn, pool_allocator<int>)->Range(min_size, max_size);
+
+BENCHMARK_TEMPLATE(map_churn, std::allocator<std::pair<const int, int>>)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(map_churn, pool_allocator<std::pair<const int, int>>)->Range(min_size, max_size);
+
+BENCHMARK_TEMPLATE(queue_churn, std::allocator<int>)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(queue_churn, pool_allocator<int>)->Range(min_size, max_size);
+
+BENCHMARK_TEMPLATE(priority_queue_churn, std::allocator<int>)->Range(min_size, max_size)->Complexity();
+BENCHMARK_TEMPLATE(priority_queue_churn, pool_allocator<int>)->Range(min_size, max_size)->Complexity();
+
+BENCHMARK_TEMPLATE(queue_iterate, std::allocator<int>)->Range(min_size, max_size);
+BENCHMARK_TEMPLATE(queue_iterate, pool_allocator<int>)->Range(min_size, max_size);
+
+BENCHMARK_TEMPLATE(queue_end, std::allocator<int>)->Range(min_size, max_size)->Complexity();
+BENCHMARK_TEMPLATE(queue_end, pool_allocator<int>)->Range(min_size, max_size)->Complexity();
+
+BENCHMARK_TEMPLATE(queue_insert_erase_middle, std::allocator<int>)->Range(min_size, max_size)->Complexity();
+BENCHMARK_TEMPLATE(queue_insert_erase_middle, pool_allocator<int>)->Range(min_size, max_size)->Complexity();
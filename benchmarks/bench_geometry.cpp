@@ -0,0 +1,67 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <point.hpp>
+#include <polygon.hpp>
+
+namespace
+{
+    template <size_t N>
+    std::vector<basic_polygon<point2d, N>> make_polygons(size_t count)
+    {
+        std::mt19937                           gen{42};
+        std::uniform_real_distribution<double> dist{-1000.0, 1000.0};
+
+        std::vector<basic_polygon<point2d, N>> polygons(count);
+        for (auto& polygon : polygons)
+        {
+            for (auto& p : polygon)
+            {
+                p = point2d{ { dist(gen), dist(gen) } };
+            }
+        }
+        return polygons;
+    }
+
+    template <size_t N>
+    void area(benchmark::State& state)
+    {
+        const auto polygons = make_polygons<N>(state.range(0));
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (const auto& polygon : polygons)
+            {
+                sum += area2d(polygon);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <size_t N>
+    void center(benchmark::State& state)
+    {
+        const auto polygons = make_polygons<N>(state.range(0));
+        for (auto _ : state)
+        {
+            point2d sum{};
+            for (const auto& polygon : polygons)
+            {
+                sum = sum + center2d(polygon);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK_TEMPLATE(area, 4)->Range(1 << 6, 1 << 16);
+BENCHMARK_TEMPLATE(area, 5)->Range(1 << 6, 1 << 16);
+BENCHMARK_TEMPLATE(area, 6)->Range(1 << 6, 1 << 16);
+
+BENCHMARK_TEMPLATE(center, 4)->Range(1 << 6, 1 << 16);
+BENCHMARK_TEMPLATE(center, 5)->Range(1 << 6, 1 << 16);
+BENCHMARK_TEMPLATE(center, 6)->Range(1 << 6, 1 << 16);
@@ -0,0 +1,54 @@
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <repl.hpp>
+
+namespace
+{
+    using engine = oop::basic_repl<1 << 18>;
+
+    std::unique_ptr<engine> make_engine(std::ostream& out, size_t count, size_t threads)
+    {
+        std::mt19937                           gen{42};
+        std::uniform_real_distribution<double> position{-1000.0, 1000.0};
+        std::uniform_real_distribution<double> half{1.0, 50.0};
+
+        std::stringstream commands;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const double x = position(gen), y = position(gen), a = half(gen), b = half(gen);
+            commands << x + a << ' ' << y << ' ' << x << ' ' << y + b << ' '
+                     << x - a << ' ' << y << ' ' << x << ' ' << y - b << '\n';
+        }
+
+        auto repl = std::make_unique<engine>(commands, out);
+        for (size_t i = 0; i < count; ++i)
+        {
+            repl->execute("push");
+        }
+        repl->set_threads(threads);
+        return repl;
+    }
+
+    // whole-queue print, the argument is the number of pool threads, 0 means one per hardware thread
+    void print_queue(benchmark::State& state)
+    {
+        constexpr size_t count = 200000;
+
+        std::ostringstream out;
+        auto repl = make_engine(out, count, static_cast<size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            out.str({});
+            repl->execute("print");
+            benchmark::DoNotOptimize(out.tellp());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+    }
+}
+
+BENCHMARK(print_queue)->Arg(1)->Arg(2)->Arg(4)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
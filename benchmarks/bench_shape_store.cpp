@@ -0,0 +1,158 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <allocator.hpp>
+#include <point.hpp>
+#include <polygon.hpp>
+#include <queue.hpp>
+#include <shape_store.hpp>
+
+namespace
+{
+    using rhombus = basic_polygon<point2d, 4>;
+    using store   = oop::shape_store<point2d, 3, 4, 5>;
+    using queue   = oop::queue<rhombus, oop::vector_allocator<rhombus, 1 << 16>>;
+
+    auto constexpr min_size = 1 << 6;
+    auto constexpr max_size = 1 << 15;
+
+    std::vector<rhombus> make_rhombi(size_t count)
+    {
+        std::mt19937                           gen{42};
+        std::uniform_real_distribution<double> position{-1000.0, 1000.0};
+        std::uniform_real_distribution<double> half{1.0, 50.0};
+
+        std::vector<rhombus> rhombi(count);
+        for (auto& r : rhombi)
+        {
+            const double x = position(gen), y = position(gen), a = half(gen), b = half(gen);
+            r = rhombus{ point2d{ { x + a, y } }, point2d{ { x, y + b } }, point2d{ { x - a, y } }, point2d{ { x, y - b } } };
+        }
+        return rhombi;
+    }
+
+    // push/pop churn: keep `size` rhombi alive and cycle one through the container
+
+    void store_churn(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        store s;
+        for (const auto& r : rhombi)
+        {
+            s.push(r);
+        }
+        size_t next = 0;
+        for (auto _ : state)
+        {
+            s.push(rhombi[next++ % rhombi.size()]);
+            s.pop();
+            benchmark::DoNotOptimize(s.size());
+        }
+    }
+
+    void queue_churn(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        queue q;
+        for (const auto& r : rhombi)
+        {
+            q.push(r);
+        }
+        size_t next = 0;
+        for (auto _ : state)
+        {
+            q.push(rhombi[next++ % rhombi.size()]);
+            q.pop();
+            benchmark::DoNotOptimize(q.top());
+        }
+    }
+
+    // whole-container scan, the workload of `less` and `aggregate`
+
+    void store_area_scan(benchmark::State& state)
+    {
+        store s;
+        for (const auto& r : make_rhombi(state.range(0)))
+        {
+            s.push(r);
+        }
+        for (auto _ : state)
+        {
+            double sum = 0;
+            s.for_each([&sum](const auto& polygon) { sum += area2d(polygon); });
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void queue_area_scan(benchmark::State& state)
+    {
+        queue q;
+        for (const auto& r : make_rhombi(state.range(0)))
+        {
+            q.push(r);
+        }
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (const auto& r : q)
+            {
+                sum += area2d(r);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // erase by index in the middle
+
+    void store_erase_middle(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        store s;
+        for (const auto& r : rhombi)
+        {
+            s.push(r);
+        }
+        const size_t middle = rhombi.size() / 2;
+        for (auto _ : state)
+        {
+            s.insert(middle, rhombi[middle]);
+            s.erase(middle);
+        }
+        state.SetComplexityN(state.range(0));
+    }
+
+    void queue_erase_middle(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        queue q;
+        for (const auto& r : rhombi)
+        {
+            q.push(r);
+        }
+        const size_t middle = rhombi.size() / 2;
+        for (auto _ : state)
+        {
+            auto it = q.begin();
+            for (size_t i = 0; i < middle; ++i)
+            {
+                ++it;
+            }
+            q.insert(it, rhombi[middle]);
+            q.erase(it);
+        }
+        state.SetComplexityN(state.range(0));
+    }
+}
+
+BENCHMARK(store_churn)->Range(min_size, max_size);
+BENCHMARK(queue_churn)->Range(min_size, max_size);
+
+BENCHMARK(store_area_scan)->Range(min_size, max_size);
+BENCHMARK(queue_area_scan)->Range(min_size, max_size);
+
+BENCHMARK(store_erase_middle)->Range(min_size, max_size)->Complexity();
+BENCHMARK(queue_erase_middle)->Range(min_size, max_size)->Complexity();
@@ -0,0 +1,86 @@
+#include <cmath>
+#include <deque>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <point.hpp>
+#include <polygon.hpp>
+#include <spatial_index.hpp>
+
+namespace
+{
+    using rhombus = basic_polygon<point2d, 4>;
+
+    std::deque<rhombus> make_rhombi(size_t count)
+    {
+        // keep the density constant: the plane grows with the number of shapes
+        const double side = std::sqrt(static_cast<double>(count)) * 20;
+
+        std::mt19937                           gen{42};
+        std::uniform_real_distribution<double> position{0.0, side};
+        std::uniform_real_distribution<double> half{1.0, 20.0};
+
+        std::deque<rhombus> rhombi;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const double x = position(gen), y = position(gen), a = half(gen), b = half(gen);
+            rhombi.push_back({ point2d{ { x + a, y } }, point2d{ { x, y + b } },
+                               point2d{ { x - a, y } }, point2d{ { x, y - b } } });
+        }
+        return rhombi;
+    }
+
+    void contains_scan(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        const point2d p{ { 100, 100 } };
+        for (auto _ : state)
+        {
+            size_t found = 0;
+            for (const auto& r : rhombi)
+            {
+                found += oop::detail::inside(oop::detail::vertices(r), p);
+            }
+            benchmark::DoNotOptimize(found);
+        }
+    }
+
+    void contains_index(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        oop::spatial_index<rhombus> index;
+        for (const auto& r : rhombi)
+        {
+            index.insert(&r);
+        }
+
+        const point2d p{ { 100, 100 } };
+        for (auto _ : state)
+        {
+            size_t found = 0;
+            index.contains(p, [&found](const rhombus*) { ++found; });
+            benchmark::DoNotOptimize(found);
+        }
+    }
+
+    void nearest_index(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        oop::spatial_index<rhombus> index;
+        for (const auto& r : rhombi)
+        {
+            index.insert(&r);
+        }
+
+        const point2d p{ { 100, 100 } };
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(index.nearest(p, 8));
+        }
+    }
+}
+
+BENCHMARK(contains_scan)->Range(1 << 10, 1 << 20);
+BENCHMARK(contains_index)->Range(1 << 10, 1 << 20);
+BENCHMARK(nearest_index)->Range(1 << 10, 1 << 20);
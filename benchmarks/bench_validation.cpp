@@ -0,0 +1,113 @@
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <point.hpp>
+#include <polygon.hpp>
+#include <validation.hpp>
+
+namespace
+{
+    auto constexpr tolerance = 0.000000001;
+
+    using rhombus = basic_polygon<point2d, 4>;
+
+    std::vector<rhombus> make_rhombi(size_t count)
+    {
+        std::mt19937                           gen{42};
+        std::uniform_real_distribution<double> position{-1000.0, 1000.0};
+        std::uniform_real_distribution<double> half{1.0, 50.0};
+        std::uniform_real_distribution<double> angle{0.0, 2 * M_PI};
+
+        std::vector<rhombus> rhombi(count);
+        for (auto& r : rhombi)
+        {
+            const point2d c{ { position(gen), position(gen) } };
+            const double  phi = angle(gen), a = half(gen), b = half(gen);
+            const point2d u{ { a * std::cos(phi), a * std::sin(phi) } };
+            const point2d v{ { -b * std::sin(phi), b * std::cos(phi) } };
+            r = { c + u, c + v, c - u, c - v };
+        }
+        return rhombi;
+    }
+
+    // equal sides by four sqrt-based distances, one shape at a time
+    void validate_distance(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        for (auto _ : state)
+        {
+            size_t valid = 0;
+            for (const auto& r : rhombi)
+            {
+                const double first = distance(r[0], r[3]);
+                bool ok = true;
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    ok &= std::abs(first - distance(r[i], r[i + 1])) <= tolerance;
+                }
+                valid += ok;
+            }
+            benchmark::DoNotOptimize(valid);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void validate_single(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        for (auto _ : state)
+        {
+            size_t valid = 0;
+            for (const auto& r : rhombi)
+            {
+                valid += oop::polygon_status(r, tolerance) == oop::shape_status::valid;
+            }
+            benchmark::DoNotOptimize(valid);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // the check read_rhombus uses
+    void validate_rhombus(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        for (auto _ : state)
+        {
+            size_t valid = 0;
+            for (const auto& r : rhombi)
+            {
+                valid += oop::valid_rhombus(r, tolerance);
+            }
+            benchmark::DoNotOptimize(valid);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void validate_batch(benchmark::State& state)
+    {
+        const auto rhombi = make_rhombi(state.range(0));
+        oop::polygon_batch<4> batch;
+        batch.reserve(rhombi.size());
+        for (const auto& r : rhombi)
+        {
+            batch.push(r);
+        }
+
+        std::vector<std::uint8_t> status(batch.size());
+        for (auto _ : state)
+        {
+            batch.validate(status.data(), tolerance);
+            benchmark::DoNotOptimize(status.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK(validate_distance)->Range(1 << 6, 1 << 16);
+BENCHMARK(validate_single)->Range(1 << 6, 1 << 16);
+BENCHMARK(validate_rhombus)->Range(1 << 6, 1 << 16);
+BENCHMARK(validate_batch)->Range(1 << 6, 1 << 16);
@@ -0,0 +1,4 @@
+option(BENCHMARKS "Build google benchmark suite" OFF)
+if(BENCHMARKS)
+    add_subdirectory(benchmarks)
+endif()
@@ -33,5 +33,9 @@ set(Lib lib${ProjectName})
 verbose_log(MESSAGE "Application name: " ${App})
 verbose_log(MESSAGE "Main library name: " ${Lib})
 
+# Shapes each queue of the application and the tools can hold, the pools are reserved up front
+set(POOL_SIZE 65536 CACHE STRING "Capacity of the application queues")
+verbose_log(MESSAGE "Pool size: " ${POOL_SIZE})
+
 # Third pary environment
 set(THIRD_PARTY_FOLDER third_party CACHE STRING "Third party folder")
@@ -0,0 +1 @@
+add_subdirectory(tools)
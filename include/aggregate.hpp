@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+
+#include "point.hpp"
+#include "polygon.hpp"
+
+namespace oop
+{
+    /*!
+     * @brief Neumaier compensated sum, subtraction is adding the negated value
+     */
+    class compensated_sum
+    {
+    public:
+        void add(const double value) noexcept
+        {
+            const double t = sum_ + value;
+            if (std::abs(sum_) >= std::abs(value))
+            {
+                compensation_ += (sum_ - t) + value;
+            }
+            else
+            {
+                compensation_ += (value - t) + sum_;
+            }
+            sum_ = t;
+        }
+
+        void subtract(const double value) noexcept
+        {
+            add(-value);
+        }
+
+        [[nodiscard]] double value() const noexcept
+        {
+            return sum_ + compensation_;
+        }
+
+        void reset() noexcept
+        {
+            sum_          = 0;
+            compensation_ = 0;
+        }
+
+    private:
+        double sum_          = 0;
+        double compensation_ = 0;
+    };
+
+    /*!
+     * @brief running count, total area, area-weighted centroid and min/max area of a collection of shapes
+     *
+     * Sums are updated on every mutation. Areas are kept ordered in a multiset,
+     * so insert and erase are O(log n) wherever the shape sits in its container and every query is O(1).
+     */
+    template <typename T>
+    class running_aggregate
+    {
+    public:
+        void insert(const T& shape)
+        {
+            const double  area   = area2d(shape);
+            const point2d center = center2d(shape);
+            areas_.insert(area);
+            area_.add(area);
+            x_.add(area * center[0]);
+            y_.add(area * center[1]);
+        }
+
+        /*!
+         * @brief removes a shape inserted before, throws and keeps the sums when there is none of its area
+         */
+        void erase(const T& shape)
+        {
+            const double area = area2d(shape);
+            const auto   it   = areas_.find(area);
+            if (it == areas_.end())
+            {
+                throw std::invalid_argument{"running_aggregate: shape is not aggregated"};
+            }
+            areas_.erase(it);
+            if (areas_.empty())
+            {
+                // drop whatever rounding is left
+                clear();
+                return;
+            }
+
+            const point2d center = center2d(shape);
+            area_.subtract(area);
+            x_.subtract(area * center[0]);
+            y_.subtract(area * center[1]);
+        }
+
+        void clear() noexcept
+        {
+            areas_.clear();
+            area_.reset();
+            x_.reset();
+            y_.reset();
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return areas_.empty();
+        }
+
+        [[nodiscard]] size_t count() const noexcept
+        {
+            return areas_.size();
+        }
+
+        [[nodiscard]] double area() const noexcept
+        {
+            return area_.value();
+        }
+
+        [[nodiscard]] point2d centroid() const noexcept
+        {
+            const double area = area_.value();
+            return point2d{ { x_.value() / area, y_.value() / area } };
+        }
+
+        [[nodiscard]] double min_area() const noexcept
+        {
+            return *areas_.begin();
+        }
+
+        [[nodiscard]] double max_area() const noexcept
+        {
+            return *areas_.rbegin();
+        }
+
+        void write(std::ostream& out) const
+        {
+            out << "count:    " << count() << "\n";
+            if (empty())
+            {
+                return;
+            }
+            out << "area:     " << area() << "\n"
+                << "centroid: " << centroid() << "\n"
+                << "min area: " << min_area() << "\n"
+                << "max area: " << max_area() << "\n";
+        }
+
+    private:
+        std::multiset<double> areas_;
+        compensated_sum       area_;
+        compensated_sum       x_;
+        compensated_sum       y_;
+    };
+}
@@ -7,22 +7,41 @@
 #include <cmath>
 
 #include "point.hpp"
+#include "polygon.hpp"
 
 namespace detail {
     template<size_t _Off, size_t ... _Ix>
-    std::index_sequence<(_Off + _Ix)...> add_offset(std::index_sequence<_Ix...>) {
+    constexpr std::index_sequence<(_Off + _Ix)...> add_offset(std::index_sequence<_Ix...>) {
         return {};
     }
 
     template<size_t _Off, size_t _N>
-    auto make_index_sequence_with_offset() {
+    constexpr auto make_index_sequence_with_offset() {
         return add_offset<_Off>(std::make_index_sequence<_N>{});
     }
 
+    // std::abs is not constexpr
+    template<typename _T>
+    constexpr _T abs(const _T value) {
+        return value < 0 ? -value : value;
+    }
+
+    template<typename _T>
+    using coordinate_of = typename std::tuple_element_t<0, _T>::value_type;
+
+    template<typename _T>
+    constexpr void check_vertex() {
+        static_assert(std::tuple_element_t<0, _T>::size() == 2, "2d algorithms need 2d vertices");
+    }
+
+    /*
+        twice the signed area accumulated in the widened coordinate type
+    */
     template<typename _T, size_t... _Ix>
-    double area2d(const _T& tuple, std::index_sequence<_Ix...>) {
-        using vertex = std::remove_const_t<std::remove_reference_t<decltype(std::get<0>(tuple))>>;
-        static_assert(std::is_same_v<vertex, point2d>, "incorrect type");
+    constexpr auto twice_area2d(const _T& tuple, std::index_sequence<_Ix...>) {
+        check_vertex<_T>();
+        using traits = coordinate_traits<coordinate_of<_T>>;
+        using accumulator = typename traits::accumulator;
 
         auto constexpr tuple_size = std::tuple_size<_T>{}();
         auto constexpr x = 0;
@@ -30,48 +49,61 @@ namespace detail {
 
         using std::get;
 
-        double result = ((get<_Ix>(tuple)[x] * (get<_Ix + 1>(tuple)[y] - get<_Ix - 1>(tuple)[y])) + ...);
+        const auto w = [](const auto& p, size_t ix) constexpr { return traits::widen(p[ix]); };
+
+        accumulator result = ((w(get<_Ix>(tuple), x) * (w(get<_Ix + 1>(tuple), y) - w(get<_Ix - 1>(tuple), y))) + ...);
         auto constexpr first = 0;
         auto constexpr last = tuple_size - 1;
-        result += get<first>(tuple)[x] * (get<first + 1>(tuple)[y] - get<last>(tuple)[y]);
-        result += get<last>(tuple)[x] * (get<first>(tuple)[y] - get<last - 1>(tuple)[y]);
-        result /= 2;
+        result += w(get<first>(tuple), x) * (w(get<first + 1>(tuple), y) - w(get<last>(tuple), y));
+        result += w(get<last>(tuple), x) * (w(get<first>(tuple), y) - w(get<last - 1>(tuple), y));
 
-        return std::abs(result);
+        return detail::abs(result);
     }
 
     template<typename _T, std::size_t... _Ix>
-    auto center2d(const _T& tuple, std::index_sequence<_Ix...>) {
-        using vertex = std::remove_const_t<std::remove_reference_t<decltype(std::get<0>(tuple))>>;
-        static_assert(std::is_same_v<vertex, point2d>, "incorrect type");
+    constexpr auto center2d(const _T& tuple, std::index_sequence<_Ix...>) {
+        check_vertex<_T>();
+        using traits = coordinate_traits<coordinate_of<_T>>;
+        using accumulator = typename traits::accumulator;
 
         auto constexpr tuple_size = std::tuple_size<_T>{}();
         auto constexpr x = 0;
         auto constexpr y = 1;
 
-        vertex result = (std::get<_Ix>(tuple) + ...);
-        result[x] /= tuple_size;
-        result[y] /= tuple_size;
+        using std::get;
+
+        const accumulator sum_x = (traits::widen(get<_Ix>(tuple)[x]) + ...);
+        const accumulator sum_y = (traits::widen(get<_Ix>(tuple)[y]) + ...);
 
-        return result;
+        return point<typename traits::center_type, 2>{ {
+            traits::center(sum_x, tuple_size),
+            traits::center(sum_y, tuple_size)
+        } };
     }
 
     template<typename _T, std::size_t... _Ix>
     auto print_points2d(std::ostream& out, const _T& tuple, std::index_sequence<_Ix...>) {
-        auto constexpr tuple_size = std::tuple_size<_T>{}();
-        (out << ... << std::get<_Ix>(tuple));
+        using std::get;
+        (out << ... << get<_Ix>(tuple));
     }
 }
 
+/*
+    twice the area in the exact accumulator type of the coordinates
+*/
 template<typename _T>
-double area2d(const _T& tuple) {
+constexpr auto twice_area2d(const _T& tuple) {
     auto constexpr tuple_size = std::tuple_size<_T>{}();
-    using vertex = std::remove_reference_t<decltype(std::get<0>(tuple))>;
-    return detail::area2d(tuple, detail::make_index_sequence_with_offset<1, tuple_size - 2>());
+    return detail::twice_area2d(tuple, detail::make_index_sequence_with_offset<1, tuple_size - 2>());
 }
 
 template<typename _T>
-auto center2d(const _T& tuple) {
+constexpr auto area2d(const _T& tuple) {
+    return coordinate_traits<detail::coordinate_of<_T>>::area(twice_area2d(tuple));
+}
+
+template<typename _T>
+constexpr auto center2d(const _T& tuple) {
     auto constexpr tuple_size = std::tuple_size<_T>{}();
     return detail::center2d(tuple, std::make_index_sequence<tuple_size>{});
 }
@@ -99,4 +131,4 @@ auto print2d(std::ostream& stream, const _T& tuple) {
         << "points: ";
     detail::print_points2d(stream, tuple, std::make_index_sequence<tuple_size>{});
     stream << endl << endl;
-}
\ No newline at end of file
+}
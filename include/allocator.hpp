@@ -7,6 +7,8 @@
 #include <vector>
 #include <stdexcept>
 
+#include "errors.hpp"
+
 namespace oop
 {
     template <typename T, size_t TPoolSize>
@@ -46,11 +48,12 @@ namespace oop
             /*!
              * @brief destructor
              *
-             * Verifies that current memory container is not used.
+             * Verifies that current memory container is not used and releases it.
              */
             ~vall_values() noexcept
             {
-                assert((free.size() == mem_finish - mem_start) && "memory leak detected");
+                assert((free.size() == static_cast<size_t>(mem_finish - mem_start)) && "memory leak detected");
+                operator delete[](mem_start);
             }
 
             // MEMORY POOL METHODS:
@@ -61,7 +64,7 @@ namespace oop
 #endif
 
                 // Try reserve block fast
-                if ((mem_finish - mem_start) < TPoolSize)
+                if (static_cast<size_t>(mem_finish - mem_start) < TPoolSize)
                 {
                     T* block = mem_finish;
                     ++mem_finish;
@@ -73,6 +76,7 @@ namespace oop
                 {
                     T* block = free.back();
                     free.erase(free.begin() + free.size() - 1);
+                    is_free[block - mem_start] = false;
                     return block;
                 }
                 throw std::bad_alloc{};
@@ -86,19 +90,72 @@ namespace oop
                 }
 
                 // Verify block
-                if (block < mem_start || mem_finish < block)
+                if (block < mem_start || mem_finish <= block)
                 {
                     throw std::runtime_error{"unknown block"};
                 }
 
                 // Check UAF behaviour
-                if (auto it = std::find(free.begin(), free.end(), block); it != free.end())
+                auto flag = free_flag(block);
+                if (flag)
                 {
-                    throw std::runtime_error{"UAF detected"};
+                    throw use_after_free_error{};
                 }
 
                 // Push block to the free pool
                 free.push_back(block);
+                flag = true;
+            }
+
+            /*!
+             * @brief returns many blocks at once
+             *
+             * Every block is verified before any of them is released,
+             * a block repeated within the batch counts as a double free.
+             */
+            void free_blocks(T* const* blocks, const size_t count)
+            {
+                // Verify blocks
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (blocks[i] != nullptr && (blocks[i] < mem_start || mem_finish <= blocks[i]))
+                    {
+                        throw std::runtime_error{"unknown block"};
+                    }
+                }
+
+                free.reserve(free.size() + count);
+
+                // Check UAF behaviour
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (blocks[i] == nullptr)
+                    {
+                        continue;
+                    }
+                    auto flag = free_flag(blocks[i]);
+                    if (flag)
+                    {
+                        for (size_t j = 0; j < i; ++j)
+                        {
+                            if (blocks[j] != nullptr)
+                            {
+                                is_free[blocks[j] - mem_start] = false;
+                            }
+                        }
+                        throw use_after_free_error{};
+                    }
+                    flag = true;
+                }
+
+                // Push blocks to the free pool
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (blocks[i] != nullptr)
+                    {
+                        free.push_back(blocks[i]);
+                    }
+                }
             }
 
         private:
@@ -110,10 +167,24 @@ namespace oop
             }
 #endif
 
+            /*!
+             * @brief free mark of a handed out block, O(1) instead of searching the free pool
+             */
+            std::vector<bool>::reference free_flag(T* block)
+            {
+                const size_t ix = static_cast<size_t>(block - mem_start);
+                if (ix >= is_free.size())
+                {
+                    is_free.resize(static_cast<size_t>(mem_finish - mem_start));
+                }
+                return is_free[ix];
+            }
+
         public:
-            T*              mem_start;
-            T*              mem_finish;
-            std::vector<T*> free;
+            T*                mem_start;
+            T*                mem_finish;
+            std::vector<T*>   free;
+            std::vector<bool> is_free;
         };
 
     public:
@@ -127,11 +198,6 @@ namespace oop
         vector_allocator& operator=(const vector_allocator&) = delete;
         vector_allocator& operator=(vector_allocator&&)      = delete;
 
-        ~vector_allocator() noexcept
-        {
-            operator delete[](values_.mem_start);
-        }
-
         T* allocate(const std::size_t n)
         {
             if (n == 0)
@@ -154,6 +220,14 @@ namespace oop
             values_.free_block(block);
         }
 
+        /*!
+         * @brief deallocates `count` single blocks in one go
+         */
+        void deallocate_batch(T* const* blocks, const std::size_t count)
+        {
+            values_.free_blocks(blocks, count);
+        }
+
         static constexpr size_type max_size()
         {
             return 1;
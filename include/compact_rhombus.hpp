@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+#include "point.hpp"
+#include "polygon.hpp"
+#include "fixed_point.hpp"
+
+/*
+    basic_compact_rhombus class
+    stores a rhombus as its center and two half-diagonals, 6 scalars instead of 8
+    vertices are reconstructed on access as center + a, center + b, center - a, center - b
+    tuple-like, structured binding is available (by value)
+*/
+template<typename _Storage>
+class basic_compact_rhombus
+{
+    using storage_point = point<_Storage, 2>;
+
+public:
+    using storage = _Storage;
+    using vertex  = point2d;
+
+    constexpr basic_compact_rhombus() noexcept = default;
+
+    /*
+        the rhombus must be valid (see read_rhombus): opposite vertices share the center
+    */
+    explicit constexpr basic_compact_rhombus(const basic_polygon<point2d, 4>& r) noexcept
+        : center_(narrow(center2d(r)))
+        , a_(narrow(r[0] - center2d(r)))
+        , b_(narrow(r[1] - center2d(r)))
+    {}
+
+    [[nodiscard]] constexpr vertex center() const noexcept {
+        return widen(center_);
+    }
+
+    template<size_t _Ix>
+    [[nodiscard]] constexpr vertex get() const noexcept {
+        static_assert(_Ix < 4, "ix is out of range");
+        const vertex c = widen(center_);
+        if constexpr (_Ix == 0) {
+            return c + widen(a_);
+        }
+        else if constexpr (_Ix == 1) {
+            return c + widen(b_);
+        }
+        else if constexpr (_Ix == 2) {
+            return c - widen(a_);
+        }
+        else {
+            return c - widen(b_);
+        }
+    }
+
+    [[nodiscard]] constexpr vertex operator[](size_t ix) const {
+        switch (ix) {
+        case 0: return get<0>();
+        case 1: return get<1>();
+        case 2: return get<2>();
+        case 3: return get<3>();
+        default: throw std::out_of_range{"ix is out of range"};
+        }
+    }
+
+    /*
+        area of the rhombus is 2 |a x b|
+    */
+    [[nodiscard]] constexpr double area() const noexcept {
+        const vertex a = widen(a_);
+        const vertex b = widen(b_);
+        const double cross = a[0] * b[1] - a[1] * b[0];
+        return 2 * (cross < 0 ? -cross : cross);
+    }
+
+    [[nodiscard]] constexpr basic_polygon<point2d, 4> expand() const noexcept {
+        return { get<0>(), get<1>(), get<2>(), get<3>() };
+    }
+
+    static constexpr size_t size() {
+        return 4;
+    }
+
+private:
+    static constexpr storage_point narrow(const point2d& p) noexcept {
+        return storage_point{ { static_cast<storage>(p[0]), static_cast<storage>(p[1]) } };
+    }
+
+    static constexpr vertex widen(const storage_point& p) noexcept {
+        return vertex{ { to_double(p[0]), to_double(p[1]) } };
+    }
+
+    static constexpr double to_double(const storage& value) noexcept {
+        if constexpr (std::is_arithmetic_v<storage>) {
+            return static_cast<double>(value);
+        }
+        else {
+            return value.to_double();
+        }
+    }
+
+    storage_point center_{};
+    storage_point a_{};
+    storage_point b_{};
+};
+
+// found by argument dependent lookup next to std::get
+template<size_t _Ix, typename _Storage>
+constexpr point2d get(const basic_compact_rhombus<_Storage>& r) {
+    return r.template get<_Ix>();
+}
+
+namespace std {
+    template<typename _Storage>
+    struct tuple_size<::basic_compact_rhombus<_Storage>>
+        : integral_constant<size_t, 4> {};
+
+    template<size_t _Ix, typename _Storage>
+    struct tuple_element<_Ix, ::basic_compact_rhombus<_Storage>> {
+        using type = point2d;
+    };
+} // namespace std
+
+/*
+    area2d straight from the cross product, no reconstruction
+*/
+template<typename _Storage>
+constexpr double area2d(const basic_compact_rhombus<_Storage>& r) {
+    return r.area();
+}
+
+template<typename _Storage>
+constexpr point2d center2d(const basic_compact_rhombus<_Storage>& r) {
+    return r.center();
+}
+
+// Examples:
+using compact_rhombus   = basic_compact_rhombus<double>;
+using compact_rhombus_f = basic_compact_rhombus<float>;
+using compact_rhombus_q = basic_compact_rhombus<oop::fixed_point<int32_t, 8>>;
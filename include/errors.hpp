@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace oop
+{
+    /*!
+     * @brief thrown when an element is requested from or removed from an empty container
+     */
+    class empty_queue_error : public std::out_of_range
+    {
+    public:
+        empty_queue_error()
+            : std::out_of_range{"queue is empty"}
+        {}
+    };
+
+    /*!
+     * @brief thrown when input does not describe a valid shape
+     */
+    class bad_polygon_error : public std::invalid_argument
+    {
+    public:
+        bad_polygon_error()
+            : std::invalid_argument{"bad polygon"}
+        {}
+    };
+
+    /*!
+     * @brief thrown by the pool allocator when a block is freed twice
+     */
+    class use_after_free_error : public std::runtime_error
+    {
+    public:
+        use_after_free_error()
+            : std::runtime_error{"UAF detected"}
+        {}
+    };
+}
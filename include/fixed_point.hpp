@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+#include "point.hpp"
+
+namespace oop
+{
+    /*!
+     * @brief scaled fixed-point number: value = raw / 2^TFracBits
+     */
+    template <typename TRep, size_t TFracBits>
+    class fixed_point
+    {
+        static_assert(std::is_integral_v<TRep> && std::is_signed_v<TRep>, "fixed_point needs a signed integer representation");
+        static_assert(TFracBits < sizeof(TRep) * 8 - 1, "too many fractional bits");
+
+    public:
+        using rep = TRep;
+
+        static constexpr size_t frac_bits = TFracBits;
+        static constexpr rep    one       = rep{1} << TFracBits;
+
+        constexpr fixed_point() noexcept = default;
+
+        constexpr fixed_point(const double value) noexcept
+            : raw_(static_cast<rep>(value * one + (value < 0 ? -0.5 : 0.5)))
+        {}
+
+        [[nodiscard]] static constexpr fixed_point from_raw(const rep raw) noexcept
+        {
+            fixed_point result;
+            result.raw_ = raw;
+            return result;
+        }
+
+        [[nodiscard]] constexpr rep raw() const noexcept
+        {
+            return raw_;
+        }
+
+        [[nodiscard]] constexpr double to_double() const noexcept
+        {
+            return static_cast<double>(raw_) / one;
+        }
+
+        constexpr fixed_point& operator+=(const fixed_point other) noexcept
+        {
+            raw_ += other.raw_;
+            return *this;
+        }
+
+        constexpr fixed_point& operator-=(const fixed_point other) noexcept
+        {
+            raw_ -= other.raw_;
+            return *this;
+        }
+
+        [[nodiscard]] constexpr fixed_point operator+(const fixed_point other) const noexcept
+        {
+            return from_raw(raw_ + other.raw_);
+        }
+
+        [[nodiscard]] constexpr fixed_point operator-(const fixed_point other) const noexcept
+        {
+            return from_raw(raw_ - other.raw_);
+        }
+
+        [[nodiscard]] constexpr fixed_point operator-() const noexcept
+        {
+            return from_raw(-raw_);
+        }
+
+        [[nodiscard]] constexpr bool operator==(const fixed_point other) const noexcept
+        {
+            return raw_ == other.raw_;
+        }
+
+        [[nodiscard]] constexpr bool operator!=(const fixed_point other) const noexcept
+        {
+            return raw_ != other.raw_;
+        }
+
+        [[nodiscard]] constexpr bool operator<(const fixed_point other) const noexcept
+        {
+            return raw_ < other.raw_;
+        }
+
+    private:
+        rep raw_ = 0;
+    };
+
+    template <typename TRep, size_t TFracBits>
+    std::ostream& operator<<(std::ostream& stream, const fixed_point<TRep, TFracBits> value)
+    {
+        return stream << value.to_double();
+    }
+
+    template <typename TRep, size_t TFracBits>
+    std::istream& operator>>(std::istream& stream, fixed_point<TRep, TFracBits>& value)
+    {
+        double d;
+        if (stream >> d)
+        {
+            value = d;
+        }
+        return stream;
+    }
+}
+
+/*
+    fixed-point coordinates are accumulated on their raw integers,
+    products carry twice the fractional bits
+*/
+template <typename _Rep, size_t _FracBits>
+struct coordinate_traits<oop::fixed_point<_Rep, _FracBits>> {
+    using raw_traits  = coordinate_traits<_Rep>;
+    using accumulator = typename raw_traits::accumulator;
+    using area_type   = double;
+    using center_type = oop::fixed_point<_Rep, _FracBits>;
+
+    static constexpr accumulator widen(const center_type value) noexcept {
+        return value.raw();
+    }
+
+    static constexpr area_type area(const accumulator twice_area) noexcept {
+        return raw_traits::area(twice_area) / (static_cast<double>(center_type::one) * center_type::one);
+    }
+
+    static constexpr center_type center(const accumulator sum, const size_t n) noexcept {
+        const auto count = static_cast<accumulator>(n);
+        // round half away from zero like the double constructor
+        const accumulator rounded = (sum < 0 ? sum - count / 2 : sum + count / 2) / count;
+        return center_type::from_raw(static_cast<_Rep>(rounded));
+    }
+};
+
+// Examples:
+using point2q = point<oop::fixed_point<int32_t, 16>, 2>;
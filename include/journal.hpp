@@ -0,0 +1,605 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace oop
+{
+    /*!
+     * @brief journaled operation codes
+     */
+    enum class journal_op : std::uint8_t
+    {
+        push   = 1,
+        pop    = 2,
+        insert = 3,
+        erase  = 4,
+
+        /*!
+         * @brief bulk erase by area, the index field carries the bits of the threshold
+         */
+        drop_less = 5,
+
+        pq_push = 6,
+        pq_pop  = 7,
+    };
+
+    /*!
+     * @brief group commit window
+     *
+     * Buffered records are written and synced once the oldest of them is `max_delay` old
+     * or `max_bytes` are buffered, whichever comes first.
+     */
+    struct journal_options
+    {
+        std::chrono::microseconds max_delay = std::chrono::milliseconds{5};
+        std::size_t               max_bytes = 64 * 1024;
+    };
+
+    /*!
+     * @brief append-only binary write-ahead journal
+     *
+     * Record layout: [checksum:u32][op:u8][reserved:u8 x3][ix:u64]?[value:T]?
+     * `ix` is present for insert/erase/drop_less, `value` for push/insert/pq_push.
+     * The checksum covers everything after itself, so a torn tail is detected on replay.
+     *
+     * Appending only copies the record into a buffer. A background flusher writes and syncs
+     * the buffer, so commands never wait for the disk and an idle journal still gets synced
+     * within the commit window. Write errors are reported by the next append or commit.
+     *
+     * `compact` replaces the history with a snapshot of the state, which bounds replay by the
+     * size of the state instead of the number of commands ever run.
+     */
+    template <typename T>
+    class journal
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "journal values must be trivially copyable");
+
+        struct header
+        {
+            std::uint32_t checksum;
+            journal_op    op;
+            std::uint8_t  reserved[3];
+        };
+
+    public:
+        journal() = default;
+
+        explicit journal(const std::string& path, journal_options options = {})
+        {
+            open(path, options);
+        }
+
+        journal(const journal&) = delete;
+        journal& operator=(const journal&) = delete;
+
+        ~journal() noexcept
+        {
+            try
+            {
+                close();
+            }
+            catch (...)
+            {}
+        }
+
+        void open(const std::string& path, journal_options options = {})
+        {
+            close();
+            fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (fd_ < 0)
+            {
+                throw std::system_error{errno, std::generic_category(), "journal: can not open " + path};
+            }
+            path_     = path;
+            options_  = options;
+            records_  = 0;
+            appended_ = 0;
+            synced_   = 0;
+            stop_     = false;
+            error_    = nullptr;
+            buffer_.reserve(options_.max_bytes + record_capacity);
+            spare_.reserve(options_.max_bytes + record_capacity);
+            flusher_ = std::thread{ [this] { flush_loop(); } };
+        }
+
+        [[nodiscard]] bool is_open() const noexcept
+        {
+            return fd_ >= 0;
+        }
+
+        /*!
+         * @brief number of records in the journal: replayed ones plus those appended since
+         */
+        [[nodiscard]] std::size_t records() const noexcept
+        {
+            return records_;
+        }
+
+        /*!
+         * @brief replays every intact record and drops a torn tail
+         *
+         * `apply` is called as apply(op, ix, value) where `value` is null for ops without payload.
+         * Returns the number of replayed records.
+         */
+        template <typename F>
+        std::size_t replay(F&& apply)
+        {
+            std::vector<char> data = read_all();
+
+            std::size_t offset = 0;
+            std::size_t count  = 0;
+            while (offset + sizeof(header) <= data.size())
+            {
+                header h;
+                std::memcpy(&h, data.data() + offset, sizeof(header));
+
+                const std::size_t length = record_length(h.op);
+                if (length == 0 || offset + length > data.size()
+                    || checksum(data.data() + offset + sizeof(h.checksum), length - sizeof(h.checksum)) != h.checksum)
+                {
+                    break;
+                }
+
+                const char*   body = data.data() + offset + sizeof(header);
+                std::uint64_t ix   = 0;
+                if (has_index(h.op))
+                {
+                    std::memcpy(&ix, body, sizeof(ix));
+                    body += sizeof(ix);
+                }
+
+                if (has_value(h.op))
+                {
+                    T value;
+                    std::memcpy(&value, body, sizeof(T));
+                    apply(h.op, static_cast<std::size_t>(ix), &value);
+                }
+                else
+                {
+                    apply(h.op, static_cast<std::size_t>(ix), static_cast<const T*>(nullptr));
+                }
+
+                offset += length;
+                ++count;
+            }
+
+            if (offset != data.size() && ::ftruncate(fd_, static_cast<off_t>(offset)) != 0)
+            {
+                throw std::system_error{errno, std::generic_category(), "journal: can not drop torn tail"};
+            }
+
+            records_ = count;
+            return count;
+        }
+
+        /*!
+         * @brief replaces the whole journal with a snapshot of the current state
+         *
+         * `snapshot` is called as snapshot(emit) and has to emit(op, ix, value) the records
+         * that rebuild the state from scratch. They are synced to `<path>.snapshot` first,
+         * which is then renamed over the journal: a crash leaves either the old journal or
+         * the complete snapshot. Buffered records are flushed before, as they are part of the
+         * state the snapshot describes.
+         */
+        template <typename F>
+        void compact(F&& snapshot)
+        {
+            if (fd_ < 0)
+            {
+                return;
+            }
+
+            std::vector<char> records;
+            std::size_t       count = 0;
+            snapshot([&records, &count](journal_op op, std::size_t ix, const T* value)
+            {
+                char out[record_capacity];
+                const std::size_t length = encode(op, ix, value, out);
+                records.insert(records.end(), out, out + length);
+                ++count;
+            });
+
+            const std::string     path    = path_;
+            const journal_options options = options_;
+            const std::string     temp    = path + ".snapshot";
+            const std::size_t     history = records_;
+            close();
+            try
+            {
+                const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+                if (fd < 0)
+                {
+                    throw std::system_error{errno, std::generic_category(), "journal: can not open " + temp};
+                }
+                try
+                {
+                    write_all(fd, records);
+                    if (::fdatasync(fd) != 0)
+                    {
+                        throw std::system_error{errno, std::generic_category(), "journal: fdatasync failed"};
+                    }
+                }
+                catch (...)
+                {
+                    ::close(fd);
+                    throw;
+                }
+                ::close(fd);
+                if (::rename(temp.c_str(), path.c_str()) != 0)
+                {
+                    throw std::system_error{errno, std::generic_category(), "journal: can not replace " + path};
+                }
+                sync_directory(path);
+            }
+            catch (...)
+            {
+                // keep journaling into the old file
+                ::unlink(temp.c_str());
+                open(path, options);
+                records_ = history;
+                throw;
+            }
+            open(path, options);
+            records_ = count;
+        }
+
+        void push(const T& value)
+        {
+            append(journal_op::push, 0, &value);
+        }
+
+        void pop()
+        {
+            append(journal_op::pop, 0, nullptr);
+        }
+
+        void insert(std::size_t ix, const T& value)
+        {
+            append(journal_op::insert, ix, &value);
+        }
+
+        void erase(std::size_t ix)
+        {
+            append(journal_op::erase, ix, nullptr);
+        }
+
+        void drop_less(double area)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &area, sizeof(bits));
+            append(journal_op::drop_less, static_cast<std::size_t>(bits), nullptr);
+        }
+
+        void pq_push(const T& value)
+        {
+            append(journal_op::pq_push, 0, &value);
+        }
+
+        void pq_pop()
+        {
+            append(journal_op::pq_pop, 0, nullptr);
+        }
+
+        /*!
+         * @brief waits until every record appended so far has reached the disk
+         */
+        void commit()
+        {
+            if (fd_ < 0)
+            {
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock{ mutex_ };
+            const std::uint64_t target = appended_;
+            if (synced_ < target)
+            {
+                flush_requested_ = true;
+                wake_.notify_one();
+                synced_cv_.wait(lock, [this, target] { return synced_ >= target; });
+            }
+            if (error_)
+            {
+                std::rethrow_exception(error_);
+            }
+        }
+
+        void close()
+        {
+            if (fd_ < 0)
+            {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock{ mutex_ };
+                stop_ = true;
+            }
+            // the flusher writes whatever is still buffered before it exits
+            wake_.notify_one();
+            flusher_.join();
+
+            ::close(fd_);
+            fd_ = -1;
+            if (error_)
+            {
+                std::rethrow_exception(std::exchange(error_, nullptr));
+            }
+        }
+
+    private:
+        static constexpr std::size_t record_capacity = sizeof(header) + sizeof(std::uint64_t) + sizeof(T);
+
+        static constexpr bool has_index(journal_op op) noexcept
+        {
+            return op == journal_op::insert || op == journal_op::erase || op == journal_op::drop_less;
+        }
+
+        static constexpr bool has_value(journal_op op) noexcept
+        {
+            return op == journal_op::push || op == journal_op::insert || op == journal_op::pq_push;
+        }
+
+        static constexpr std::size_t record_length(journal_op op) noexcept
+        {
+            switch (op)
+            {
+            case journal_op::push:
+            case journal_op::pop:
+            case journal_op::insert:
+            case journal_op::erase:
+            case journal_op::drop_less:
+            case journal_op::pq_push:
+            case journal_op::pq_pop:
+                return sizeof(header)
+                    + (has_index(op) ? sizeof(std::uint64_t) : 0)
+                    + (has_value(op) ? sizeof(T) : 0);
+            }
+            return 0;
+        }
+
+        /*!
+         * @brief FNV-1a
+         */
+        static std::uint32_t checksum(const char* data, std::size_t n) noexcept
+        {
+            std::uint32_t hash = 2166136261u;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        /*!
+         * @brief writes the record to `out`, which holds record_capacity bytes, and returns its length
+         */
+        static std::size_t encode(journal_op op, std::size_t ix, const T* value, char* out) noexcept
+        {
+            const std::size_t length = record_length(op);
+
+            header h{};
+            h.op = op;
+            std::memcpy(out, &h, sizeof(header));
+            char* body = out + sizeof(header);
+            if (has_index(op))
+            {
+                const std::uint64_t ix64 = ix;
+                std::memcpy(body, &ix64, sizeof(ix64));
+                body += sizeof(ix64);
+            }
+            if (has_value(op))
+            {
+                std::memcpy(body, value, sizeof(T));
+            }
+
+            h.checksum = checksum(out + sizeof(h.checksum), length - sizeof(h.checksum));
+            std::memcpy(out, &h.checksum, sizeof(h.checksum));
+            return length;
+        }
+
+        void append(journal_op op, std::size_t ix, const T* value)
+        {
+            if (fd_ < 0)
+            {
+                return;
+            }
+
+            char              out[record_capacity];
+            const std::size_t length = encode(op, ix, value, out);
+
+            bool wake = false;
+            {
+                std::lock_guard<std::mutex> lock{ mutex_ };
+                if (error_)
+                {
+                    std::rethrow_exception(error_);
+                }
+                if (buffer_.empty())
+                {
+                    // the first record opens the commit window
+                    first_pending_ = std::chrono::steady_clock::now();
+                    wake           = true;
+                }
+                buffer_.insert(buffer_.end(), out, out + length);
+                appended_ += length;
+                ++records_;
+                wake = wake || buffer_.size() >= options_.max_bytes;
+            }
+            if (wake)
+            {
+                wake_.notify_one();
+            }
+        }
+
+        /*!
+         * @brief background thread: writes and syncs the buffer when the commit window closes
+         */
+        void flush_loop()
+        {
+            std::unique_lock<std::mutex> lock{ mutex_ };
+            while (true)
+            {
+                const bool due = stop_ || flush_requested_ || buffer_.size() >= options_.max_bytes;
+                if (buffer_.empty())
+                {
+                    if (stop_)
+                    {
+                        break;
+                    }
+                    if (flush_requested_)
+                    {
+                        // everything requested is already synced
+                        flush_requested_ = false;
+                        continue;
+                    }
+                    wake_.wait(lock);
+                    continue;
+                }
+                if (!due && std::chrono::steady_clock::now() < first_pending_ + options_.max_delay)
+                {
+                    wake_.wait_until(lock, first_pending_ + options_.max_delay);
+                    continue;
+                }
+
+                std::swap(buffer_, spare_);
+                flush_requested_ = false;
+                const std::uint64_t target = appended_;
+                lock.unlock();
+
+                std::exception_ptr error;
+                try
+                {
+                    write_all(fd_, spare_);
+                    if (::fdatasync(fd_) != 0)
+                    {
+                        throw std::system_error{errno, std::generic_category(), "journal: fdatasync failed"};
+                    }
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                spare_.clear();
+
+                lock.lock();
+                if (error && !error_)
+                {
+                    error_ = error;
+                }
+                synced_ = target;
+                synced_cv_.notify_all();
+            }
+        }
+
+        static void write_all(const int fd, const std::vector<char>& records)
+        {
+            const char* data = records.data();
+            std::size_t left = records.size();
+            while (left > 0)
+            {
+                const ssize_t written = ::write(fd, data, left);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw std::system_error{errno, std::generic_category(), "journal: write failed"};
+                }
+                data += written;
+                left -= static_cast<std::size_t>(written);
+            }
+        }
+
+        /*!
+         * @brief makes a rename in the directory of `path` durable
+         */
+        static void sync_directory(const std::string& path)
+        {
+            const auto        slash = path.find_last_of('/');
+            const std::string dir   = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+            const int         fd    = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                throw std::system_error{errno, std::generic_category(), "journal: can not open " + dir};
+            }
+            const int result = ::fsync(fd);
+            const int error  = errno;
+            ::close(fd);
+            if (result != 0)
+            {
+                throw std::system_error{error, std::generic_category(), "journal: fsync failed on " + dir};
+            }
+        }
+
+        std::vector<char> read_all()
+        {
+            struct stat st;
+            if (::fstat(fd_, &st) != 0)
+            {
+                throw std::system_error{errno, std::generic_category(), "journal: fstat failed"};
+            }
+
+            std::vector<char> data(static_cast<std::size_t>(st.st_size));
+            std::size_t       done = 0;
+            while (done < data.size())
+            {
+                const ssize_t n = ::pread(fd_, data.data() + done, data.size() - done, static_cast<off_t>(done));
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw std::system_error{errno, std::generic_category(), "journal: read failed"};
+                }
+                if (n == 0)
+                {
+                    break;
+                }
+                done += static_cast<std::size_t>(n);
+            }
+            data.resize(done);
+            return data;
+        }
+
+        int             fd_ = -1;
+        std::string     path_;
+        journal_options options_;
+        std::size_t     records_ = 0;
+        std::thread     flusher_;
+
+        // guarded by mutex_
+        std::mutex                            mutex_;
+        std::condition_variable               wake_;      //!< wakes the flusher
+        std::condition_variable               synced_cv_; //!< wakes commit() callers
+        std::vector<char>                     buffer_;
+        std::chrono::steady_clock::time_point first_pending_;
+        std::uint64_t                         appended_        = 0; //!< bytes appended since open
+        std::uint64_t                         synced_          = 0; //!< bytes written and synced since open
+        bool                                  flush_requested_ = false;
+        bool                                  stop_            = false;
+        std::exception_ptr                    error_;
+
+        std::vector<char> spare_; //!< owned by the flusher while it writes
+    };
+}
@@ -0,0 +1,464 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "errors.hpp"
+
+namespace oop
+{
+    /*!
+     * @brief FIFO queue with O(1) immutable snapshots
+     *
+     * Elements form a singly linked list of reference counted nodes, a version is (head, count).
+     * push links a new node after the tail: older versions stop before it, so they never see it.
+     * pop only moves the head, insert and erase copy the path in front of the index and share the rest,
+     * so they cost O(ix): near the tail that is a copy of almost the whole queue.
+     * Nodes are freed when the last version referring to them is gone.
+     *
+     * Mutations and snapshot() are serialized by a mutex, snapshots are read without locking.
+     * Nodes come from `TBaseAllocator`, which is shared with the snapshots, so it lives as long as
+     * the last of them. Allocators that are not always equal are assumed to be stateful and are
+     * only used under a lock, as snapshots may free nodes on any thread.
+     */
+    template <typename T, typename TBaseAllocator = std::allocator<T>>
+    class persistent_queue
+    {
+        /*!
+         * @brief intrusively reference counted node, every `next` link and every version head owns one reference
+         */
+        struct node
+        {
+            T                           value;
+            node*                       next = nullptr;
+            mutable std::atomic<size_t> refs{ 1 };
+
+            explicit node(const T& v)
+                : value(v)
+            {}
+        };
+
+        /*!
+         * @brief internal allocator type
+         */
+        using allocator = typename std::allocator_traits<TBaseAllocator>::template rebind_alloc<node>;
+
+        /*!
+         * @brief allocator shared by the queue and its snapshots
+         */
+        struct pool
+        {
+            allocator  al;
+            std::mutex mutex;
+
+            std::unique_lock<std::mutex> lock()
+            {
+                if constexpr (std::allocator_traits<allocator>::is_always_equal::value)
+                {
+                    return {};
+                }
+                else
+                {
+                    return std::unique_lock<std::mutex>{ mutex };
+                }
+            }
+        };
+
+        template <typename N>
+        static N* acquire(N* n) noexcept
+        {
+            if (n)
+            {
+                n->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+            return n;
+        }
+
+        /*!
+         * @brief drops one reference and frees the uniquely owned part of the chain iteratively
+         */
+        static void release(pool* p, const node* n) noexcept
+        {
+            if (!n || n->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                return;
+            }
+
+            const auto lock = p->lock();
+            do
+            {
+                node* dead = const_cast<node*>(n);
+                n = n->next;
+                std::allocator_traits<allocator>::destroy(p->al, dead);
+                p->al.deallocate(dead, 1);
+            } while (n && n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1);
+        }
+
+    public:
+        struct const_iterator
+        {
+            using value_type        = T;
+            using reference         = const T&;
+            using pointer           = const T*;
+            using difference_type   = ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            const_iterator() = default;
+
+            const T& operator*() const noexcept
+            {
+                return node_->value;
+            }
+
+            const T* operator->() const noexcept
+            {
+                return &node_->value;
+            }
+
+            const_iterator& operator++()
+            {
+                if (left_ == 0)
+                {
+                    throw std::out_of_range{"iterator is out of range"};
+                }
+                // the last node of a version may already have a successor it must not see
+                node_ = --left_ > 0 ? node_->next : nullptr;
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                const_iterator it = *this;
+                ++(*this);
+                return it;
+            }
+
+            bool operator==(const const_iterator& other) const noexcept
+            {
+                return node_ == other.node_;
+            }
+
+            bool operator!=(const const_iterator& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+        private:
+            const_iterator(const node* n, size_t left) noexcept
+                : node_(left > 0 ? n : nullptr)
+                , left_(left)
+            {}
+
+            const node* node_ = nullptr;
+            size_t      left_ = 0;
+
+            friend persistent_queue;
+        };
+
+        /*!
+         * @brief immutable version of the queue, cheap to copy, safe to read from any thread
+         */
+        class snapshot
+        {
+        public:
+            snapshot() = default;
+
+            snapshot(const snapshot& other) noexcept
+                : pool_(other.pool_)
+                , head_(acquire(other.head_))
+                , size_(other.size_)
+            {}
+
+            snapshot(snapshot&& other) noexcept
+                : pool_(std::move(other.pool_))
+                , head_(std::exchange(other.head_, nullptr))
+                , size_(std::exchange(other.size_, 0))
+            {}
+
+            snapshot& operator=(snapshot other) noexcept
+            {
+                std::swap(pool_, other.pool_);
+                std::swap(head_, other.head_);
+                std::swap(size_, other.size_);
+                return *this;
+            }
+
+            ~snapshot()
+            {
+                release(pool_.get(), head_);
+            }
+
+            [[nodiscard]] size_t size() const noexcept
+            {
+                return size_;
+            }
+
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return size_ == 0;
+            }
+
+            [[nodiscard]] const T& top() const
+            {
+                if (size_ == 0)
+                {
+                    throw empty_queue_error{};
+                }
+                return head_->value;
+            }
+
+            const_iterator begin() const noexcept
+            {
+                return { head_, size_ };
+            }
+
+            const_iterator end() const noexcept
+            {
+                return {};
+            }
+
+        private:
+            snapshot(std::shared_ptr<pool> p, const node* head, size_t size) noexcept
+                : pool_(std::move(p))
+                , head_(head)
+                , size_(size)
+            {}
+
+            std::shared_ptr<pool> pool_;
+            const node*           head_ = nullptr;
+            size_t                size_ = 0;
+
+            friend persistent_queue;
+        };
+
+        persistent_queue()
+            : pool_(std::make_shared<pool>())
+        {}
+
+        persistent_queue(const persistent_queue&) = delete;
+        persistent_queue& operator=(const persistent_queue&) = delete;
+
+        ~persistent_queue()
+        {
+            release(pool_.get(), head_);
+        }
+
+        [[nodiscard]] snapshot get_snapshot() const
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            return { pool_, acquire(head_), size_ };
+        }
+
+        [[nodiscard]] size_t size() const
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            return size_;
+        }
+
+        /*!
+         * @brief copy of the first element, a reference could be popped by another thread
+         */
+        [[nodiscard]] T top() const
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            if (size_ == 0)
+            {
+                throw empty_queue_error{};
+            }
+            return head_->value;
+        }
+
+        void push(const T& v)
+        {
+            node* obj = make_node(v);
+
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            append(obj);
+        }
+
+        void pop()
+        {
+            const node* old;
+            {
+                std::lock_guard<std::mutex> lock{ mutex_ };
+                if (size_ == 0)
+                {
+                    throw empty_queue_error{};
+                }
+                old   = head_;
+                head_ = size_ > 1 ? acquire(head_->next) : nullptr;
+                if (--size_ == 0)
+                {
+                    tail_ = nullptr;
+                }
+            }
+            // nodes no version refers to any more are freed outside the lock
+            release(pool_.get(), old);
+        }
+
+        /*!
+         * @brief inserts `v` before the ix-th element, copies the ix elements in front of it
+         *
+         * Appending at ix == size() shares everything, any other position is O(ix).
+         */
+        void insert(size_t ix, const T& v)
+        {
+            node* obj = make_node(v);
+
+            const node* old;
+            try
+            {
+                std::lock_guard<std::mutex> lock{ mutex_ };
+                if (ix > size_)
+                {
+                    throw std::out_of_range{"iterator is out of range"};
+                }
+                if (ix == size_)
+                {
+                    // appending shares everything
+                    append(obj);
+                    return;
+                }
+
+                auto [first, last, at] = copy_prefix(ix);
+                obj->next = acquire(at);
+                if (last)
+                {
+                    last->next = obj;
+                }
+                else
+                {
+                    first = obj;
+                }
+                old   = head_;
+                head_ = first;
+                ++size_;
+            }
+            catch (...)
+            {
+                release(pool_.get(), obj);
+                throw;
+            }
+            release(pool_.get(), old);
+        }
+
+        /*!
+         * @brief erases the ix-th element, copies the ix elements in front of it
+         *
+         * O(ix): erasing near the tail copies almost the whole queue.
+         */
+        void erase(size_t ix)
+        {
+            const node* old;
+            {
+                std::lock_guard<std::mutex> lock{ mutex_ };
+                if (ix >= size_)
+                {
+                    throw std::out_of_range{"erase iterator is out of range"};
+                }
+
+                auto [first, last, at] = copy_prefix(ix);
+                node* rest = size_ - ix > 1 ? acquire(at->next) : nullptr;
+                if (last)
+                {
+                    last->next = rest;
+                }
+                else
+                {
+                    first = rest;
+                }
+                old   = head_;
+                head_ = first;
+                if (ix == size_ - 1)
+                {
+                    tail_ = last;
+                }
+                --size_;
+            }
+            release(pool_.get(), old);
+        }
+
+    private:
+        struct prefix
+        {
+            node*       first;
+            node*       last;
+            node*       at;
+        };
+
+        node* make_node(const T& v) const
+        {
+            const auto lock = pool_->lock();
+            node* obj = pool_->al.allocate(1);
+            try
+            {
+                std::allocator_traits<allocator>::construct(pool_->al, obj, v);
+            }
+            catch (...)
+            {
+                pool_->al.deallocate(obj, 1);
+                throw;
+            }
+            return obj;
+        }
+
+        void append(node* obj) noexcept
+        {
+            if (tail_)
+            {
+                tail_->next = obj;
+            }
+            else
+            {
+                head_ = obj;
+            }
+            tail_ = obj;
+            ++size_;
+        }
+
+        /*!
+         * @brief copies the first n nodes
+         *
+         * Returns the copy, whose last node has no successor yet, and the n-th node of the current version.
+         */
+        prefix copy_prefix(size_t n) const
+        {
+            prefix result{ nullptr, nullptr, head_ };
+            try
+            {
+                for (size_t i = 0; i < n; ++i, result.at = result.at->next)
+                {
+                    node* obj = make_node(result.at->value);
+                    if (result.last)
+                    {
+                        result.last->next = obj;
+                    }
+                    else
+                    {
+                        result.first = obj;
+                    }
+                    result.last = obj;
+                }
+            }
+            catch (...)
+            {
+                release(pool_.get(), result.first);
+                throw;
+            }
+            return result;
+        }
+
+        std::shared_ptr<pool> pool_;
+
+        mutable std::mutex mutex_;
+        node*              head_ = nullptr;
+        node*              tail_ = nullptr;
+        size_t             size_ = 0;
+    };
+}
@@ -2,7 +2,66 @@
 
 #include <iostream>
 #include <cstddef>
+#include <cstdint>
 #include <cmath>
+#include <type_traits>
+
+/*
+    coordinate_traits
+    how geometry algorithms accumulate and report values of a coordinate type
+*/
+template <typename _Type, typename = void>
+struct coordinate_traits {
+    static_assert(std::is_floating_point_v<_Type>, "unsupported coordinate type");
+
+    // float is accumulated in double to keep cancellation in check
+    using accumulator = std::conditional_t<(sizeof(_Type) < sizeof(double)), double, _Type>;
+    using area_type   = accumulator;
+    using center_type = _Type;
+
+    static constexpr accumulator widen(const _Type value) noexcept {
+        return value;
+    }
+
+    static constexpr area_type area(const accumulator twice_area) noexcept {
+        return twice_area / 2;
+    }
+
+    static constexpr center_type center(const accumulator sum, const size_t n) noexcept {
+        return static_cast<center_type>(sum / static_cast<accumulator>(n));
+    }
+};
+
+/*
+    integral coordinates are accumulated exactly as long as the shoelace sum fits,
+    every term is at most 2 * max|c|^2, supported ranges for polygons of fewer than 16 vertices:
+    - 8 and 16 bit coordinates: any value, in int64_t
+    - 32 bit coordinates: any value in __int128, |c| < 2^29 where only int64_t is available
+    - 64 bit coordinates: |c| < 2^61, only with __int128
+*/
+template <typename _Type>
+struct coordinate_traits<_Type, std::enable_if_t<std::is_integral_v<_Type>>> {
+#if defined(__SIZEOF_INT128__)
+    using accumulator = std::conditional_t<(sizeof(_Type) < sizeof(int32_t)), int64_t, __int128>;
+#else
+    static_assert(sizeof(_Type) <= sizeof(int32_t), "64 bit integer coordinates need __int128 accumulation");
+    using accumulator = int64_t;
+#endif
+    using area_type   = double;
+    using center_type = double;
+
+    static constexpr accumulator widen(const _Type value) noexcept {
+        return value;
+    }
+
+    static constexpr area_type area(const accumulator twice_area) noexcept {
+        return static_cast<double>(twice_area) / 2;
+    }
+
+    static constexpr center_type center(const accumulator sum, const size_t n) noexcept {
+        return static_cast<double>(sum) / static_cast<double>(n);
+    }
+};
 
 template <typename _Type, size_t _Dimensions>
 struct point {
@@ -19,35 +78,35 @@ struct point {
 
     value_type dots[_Dimensions];
 
-    [[nodiscard]] value_type& operator[](size_t ix) noexcept {
+    [[nodiscard]] constexpr value_type& operator[](size_t ix) noexcept {
         return dots[ix];
     }
 
-    [[nodiscard]] const value_type& operator[](size_t ix) const noexcept {
-        return const_cast<point&>(*this).operator[](ix);
+    [[nodiscard]] constexpr const value_type& operator[](size_t ix) const noexcept {
+        return dots[ix];
     }
 
-    [[nodiscard]] iterator begin() noexcept {
+    [[nodiscard]] constexpr iterator begin() noexcept {
         return &dots[0];
     }
 
-    [[nodiscard]] const_iterator begin() const noexcept {
-        return const_cast<point&>(*this).begin();
+    [[nodiscard]] constexpr const_iterator begin() const noexcept {
+        return &dots[0];
     }
 
-    [[nodiscard]] iterator end() noexcept {
-        return &dots[_Dimensions];
+    [[nodiscard]] constexpr iterator end() noexcept {
+        return &dots[0] + _Dimensions;
     }
 
-    [[nodiscard]] const_iterator end() const noexcept {
-        return const_cast<point&>(*this).end();
+    [[nodiscard]] constexpr const_iterator end() const noexcept {
+        return &dots[0] + _Dimensions;
     }
 
     [[nodiscard]] static constexpr size_t size() noexcept {
         return _Dimensions;
     }
 
-    [[nodiscard]] point operator+(const point& other) const {
+    [[nodiscard]] constexpr point operator+(const point& other) const {
         point result = *this;
 
         for (size_t i = 0; i < result.size(); i++) {
@@ -57,7 +116,7 @@ struct point {
         return result;
     }
 
-    [[nodiscard]] point operator-(const point& other) const {
+    [[nodiscard]] constexpr point operator-(const point& other) const {
         point result = *this;
 
         for (size_t i = 0; i < result.size(); i++) {
@@ -66,6 +125,19 @@ struct point {
 
         return result;
     }
+
+    [[nodiscard]] constexpr bool operator==(const point& other) const {
+        for (size_t i = 0; i < size(); i++) {
+            if (dots[i] != other.dots[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] constexpr bool operator!=(const point& other) const {
+        return !(*this == other);
+    }
 };
 
 template <typename Type, size_t _Dims>
@@ -90,6 +162,8 @@ std::istream& operator>>(std::istream& stream, point<_Type, _Dims>& p) {
 
 // Examples:
 using point2d = point<double, 2>;
+using point2f = point<float, 2>;
+using point2i = point<int32_t, 2>;
 
 inline double distance(const point2d& left, const point2d& right) {
     const double x = left[0] - right[0];
@@ -7,6 +7,8 @@
 #include <ostream>
 #include <stdexcept>
 
+#include "point.hpp"
+
 template<typename _T>
 auto print2d(std::ostream& stream, const _T& tuple);
 
@@ -48,7 +50,9 @@ public:
 
 
     // constructors
-    basic_polygon() = default;
+    constexpr basic_polygon() noexcept
+        : points{}
+    {}
     explicit basic_polygon(std::istream& stream) {
         for (auto& point : points) {
             stream >> point;
@@ -57,49 +61,55 @@ public:
             throw std::runtime_error("bad polygon initialization");
         }
     }
-    explicit basic_polygon(const vertex& v) noexcept {
+    explicit constexpr basic_polygon(const vertex& v) noexcept
+        : points{}
+    {
         for (auto& point : points) {
             point = v;
         }
     }
+    template<typename... _V,
+             typename = std::enable_if_t<sizeof...(_V) == _NumOfPoints
+                                         && (std::is_convertible_v<const _V&, vertex> && ...)>>
+    constexpr basic_polygon(const _V&... vertices) noexcept
+        : points{ vertices... }
+    {}
 
 
 
     // element getters
-    reference at(size_t ix) {
+    constexpr reference at(size_t ix) {
         return points[ix];
     }
-    const_reference at(size_t ix) const {
-        return const_cast<basic_polygon&>(*this).at(ix);
+    constexpr const_reference at(size_t ix) const {
+        return points[ix];
     }
 
-    reference operator[](size_t ix) {
-        return at(ix);
+    constexpr reference operator[](size_t ix) {
+        return points[ix];
     }
-    const_reference operator[](size_t ix) const {
-        return const_cast<basic_polygon&>(*this)[ix];
+    constexpr const_reference operator[](size_t ix) const {
+        return points[ix];
     }
 
 
 
     // iterators
-    iterator begin() {
+    constexpr iterator begin() {
         return &points[0];
     }
-    const_iterator begin() const {
-        // cast const to mutable and use non-const begin
-        return const_cast<basic_polygon&>(*this).begin();
+    constexpr const_iterator begin() const {
+        return &points[0];
     }
 
     /* NEVER DEREFERENCE */
-    iterator end() {
-        return &points[_NumOfPoints];
+    constexpr iterator end() {
+        return &points[0] + _NumOfPoints;
     }
     /* NEVER DEREFERENCE */
-    const_iterator end() const {
-        // cast const to mutable and use non-const end
-        return const_cast<basic_polygon&>(*this).end();
-    };
+    constexpr const_iterator end() const {
+        return &points[0] + _NumOfPoints;
+    }
 
 
 
@@ -118,9 +128,8 @@ public:
 
     template<size_t _Ix>
     constexpr auto const& get() const& {
-        // cast const to mutable and use non-const get
-        // which does no effect on storage
-        return const_cast<basic_polygon&>(*this).get<_Ix>();
+        static_assert(_Ix < _NumOfPoints, "ix is out of range");
+        return points[_Ix];
     }
 
     template<size_t _Ix>
@@ -159,100 +168,10 @@ namespace std {
     };
 } // namespace std
 
+// geometry algorithms need std::get for basic_polygon
+#include "algorithm.hpp"
+
 template <typename _Vertex, size_t _NumOfPoints>
 void basic_polygon<_Vertex, _NumOfPoints>::write(std::ostream& s) {
     print2d(s, *this);
 }
-
-namespace detail {
-    template<size_t _Off, size_t ... _Ix>
-    std::index_sequence<(_Off + _Ix)...> add_offset(std::index_sequence<_Ix...>) {
-        return {};
-    }
-
-    template<size_t _Off, size_t _N>
-    auto make_index_sequence_with_offset() {
-        return add_offset<_Off>(std::make_index_sequence<_N>{});
-    }
-
-    template<typename _T, size_t... _Ix>
-    double area2d(const _T& tuple, std::index_sequence<_Ix...>) {
-        using vertex = std::remove_const_t<std::remove_reference_t<decltype(std::get<0>(tuple))>>;
-        static_assert(std::is_same_v<vertex, point2d>, "incorrect type");
-
-        auto constexpr tuple_size = std::tuple_size<_T>{}();
-        auto constexpr x = 0;
-        auto constexpr y = 1;
-
-        using std::get;
-
-        double result = ((get<_Ix>(tuple)[x] * (get<_Ix + 1>(tuple)[y] - get<_Ix - 1>(tuple)[y])) + ...);
-        auto constexpr first = 0;
-        auto constexpr last = tuple_size - 1;
-        result += get<first>(tuple)[x] * (get<first + 1>(tuple)[y] - get<last>(tuple)[y]);
-        result += get<last>(tuple)[x] * (get<first>(tuple)[y] - get<last - 1>(tuple)[y]);
-        result /= 2;
-
-        return std::abs(result);
-    }
-
-    template<typename _T, std::size_t... _Ix>
-    auto center2d(const _T& tuple, std::index_sequence<_Ix...>) {
-        using vertex = std::remove_const_t<std::remove_reference_t<decltype(std::get<0>(tuple))>>;
-        static_assert(std::is_same_v<vertex, point2d>, "incorrect type");
-
-        auto constexpr tuple_size = std::tuple_size<_T>{}();
-        auto constexpr x = 0;
-        auto constexpr y = 1;
-
-        vertex result = (std::get<_Ix>(tuple) + ...);
-        result[x] /= tuple_size;
-        result[y] /= tuple_size;
-
-        return result;
-    }
-
-    template<typename _T, std::size_t... _Ix>
-    auto print_points2d(std::ostream& out, const _T& tuple, std::index_sequence<_Ix...>) {
-        auto constexpr tuple_size = std::tuple_size<_T>{}();
-        (out << ... << std::get<_Ix>(tuple));
-    }
-}
-
-template<typename _T>
-double area2d(const _T& tuple) {
-    auto constexpr tuple_size = std::tuple_size<_T>{}();
-    using vertex = std::remove_reference_t<decltype(std::get<0>(tuple))>;
-    return detail::area2d(tuple, detail::make_index_sequence_with_offset<1, tuple_size - 2>());
-}
-
-template<typename _T>
-auto center2d(const _T& tuple) {
-    auto constexpr tuple_size = std::tuple_size<_T>{}();
-    return detail::center2d(tuple, std::make_index_sequence<tuple_size>{});
-}
-
-template<typename _T>
-auto print2d(std::ostream& stream, const _T& tuple) {
-    auto constexpr tuple_size = std::tuple_size<_T>{}();
-
-    using std::endl;
-
-    stream << "\ntype:   ";
-    switch (tuple_size) {
-    case 4:
-        stream << "rhombus" << endl; break;
-    case 5:
-        stream << "pentagon" << endl; break;
-    case 6:
-        stream << "hexagon" << endl; break;
-    default:
-        stream << "unknown" << endl;
-    }
-
-    stream << "center: " << center2d(tuple) << endl
-        << "area:   " << area2d(tuple) << endl
-        << "points: ";
-    detail::print_points2d(stream, tuple, std::make_index_sequence<tuple_size>{});
-    stream << endl << endl;
-}
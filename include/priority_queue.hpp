@@ -0,0 +1,310 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "allocator.hpp"
+#include "errors.hpp"
+#include "polygon.hpp"
+
+namespace oop
+{
+    /*!
+     * @brief default priority: area of the polygon
+     */
+    struct area_of
+    {
+        template <typename T>
+        auto operator()(const T& shape) const
+        {
+            return area2d(shape);
+        }
+    };
+
+    /*!
+     * @brief addressable d-ary heap
+     *
+     * Values live in nodes drawn one at a time from the allocator, like oop::queue.
+     * The heap array stores (key, node) pairs so sifting compares keys without touching the nodes.
+     * Every node remembers its heap position, which makes handles usable for update and erase.
+     * As with std::priority_queue, top() is the greatest element by TCompare.
+     */
+    template <typename T,
+              typename TProjection    = area_of,
+              typename TCompare       = std::less<>,
+              size_t   TArity         = 4,
+              typename TBaseAllocator = std::allocator<T>>
+    class priority_queue
+    {
+        static_assert(TArity >= 2, "heap arity must be at least 2");
+
+    public:
+        using key_type = std::decay_t<decltype(std::declval<const TProjection&>()(std::declval<const T&>()))>;
+
+    private:
+        struct node
+        {
+            T      value;
+            size_t pos;
+
+            node(const T& v, size_t p)
+                : value(v)
+                , pos(p)
+            {}
+        };
+
+        struct entry
+        {
+            key_type key;
+            node*    n;
+        };
+
+        using allocator = typename std::allocator_traits<TBaseAllocator>::template rebind_alloc<node>;
+
+    public:
+        /*!
+         * @brief stable reference to a pushed element, valid until it is popped or erased
+         */
+        class handle
+        {
+        public:
+            handle() = default;
+
+            bool operator==(const handle& other) const noexcept
+            {
+                return node_ == other.node_;
+            }
+
+            bool operator!=(const handle& other) const noexcept
+            {
+                return node_ != other.node_;
+            }
+
+        private:
+            explicit handle(node* n) noexcept
+                : node_(n)
+            {}
+
+            node* node_ = nullptr;
+
+            friend priority_queue;
+        };
+
+        explicit priority_queue(TProjection projection = {}, TCompare compare = {})
+            : projection_(std::move(projection))
+            , compare_(std::move(compare))
+        {}
+
+        priority_queue(const priority_queue&) = delete;
+        priority_queue& operator=(const priority_queue&) = delete;
+
+        ~priority_queue()
+        {
+            for (const entry& e : heap_)
+            {
+                release(e.n);
+            }
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return heap_.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return heap_.empty();
+        }
+
+        handle push(const T& v)
+        {
+            const key_type key = projection_(v);
+
+            node* obj = al_.allocate(1);
+            try
+            {
+                std::allocator_traits<allocator>::construct(al_, obj, v, heap_.size());
+            }
+            catch (...)
+            {
+                al_.deallocate(obj, 1);
+                throw;
+            }
+
+            try
+            {
+                heap_.push_back({ key, obj });
+            }
+            catch (...)
+            {
+                release(obj);
+                throw;
+            }
+            sift_up(heap_.size() - 1);
+            return handle{ obj };
+        }
+
+        [[nodiscard]] const T& top() const
+        {
+            if (heap_.empty())
+            {
+                throw empty_queue_error{};
+            }
+            return heap_.front().n->value;
+        }
+
+        [[nodiscard]] const key_type& top_key() const
+        {
+            if (heap_.empty())
+            {
+                throw empty_queue_error{};
+            }
+            return heap_.front().key;
+        }
+
+        void pop()
+        {
+            if (heap_.empty())
+            {
+                throw empty_queue_error{};
+            }
+            remove_at(0);
+        }
+
+        [[nodiscard]] const T& value(handle h) const noexcept
+        {
+            return h.node_->value;
+        }
+
+        /*!
+         * @brief replaces the value behind `h` and restores the heap order
+         *
+         * Covers decrease-key and increase-key: the element moves in whichever direction its new key requires.
+         */
+        void update(handle h, const T& v)
+        {
+            const key_type key = projection_(v);
+            h.node_->value = v;
+
+            const size_t pos = h.node_->pos;
+            heap_[pos].key = key;
+            sift_up(pos);
+            sift_down(h.node_->pos);
+        }
+
+        void erase(handle h)
+        {
+            remove_at(h.node_->pos);
+        }
+
+        /*!
+         * @brief visits the values in heap order, pushing them in this order rebuilds the same heap
+         */
+        template <typename F>
+        void for_each(F&& visit) const
+        {
+            for (const entry& e : heap_)
+            {
+                visit(e.n->value);
+            }
+        }
+
+    private:
+        void remove_at(size_t pos)
+        {
+            node* dead = heap_[pos].n;
+            const size_t last = heap_.size() - 1;
+            if (pos != last)
+            {
+                move(heap_[last], pos);
+                heap_.pop_back();
+                sift_up(pos);
+                sift_down(heap_[pos].n->pos);
+            }
+            else
+            {
+                heap_.pop_back();
+            }
+            release(dead);
+        }
+
+        /*!
+         * @brief true when `a` has to be above `b`
+         */
+        bool before(const entry& a, const entry& b) const
+        {
+            return compare_(b.key, a.key);
+        }
+
+        void move(const entry& e, size_t pos) noexcept
+        {
+            heap_[pos] = e;
+            e.n->pos   = pos;
+        }
+
+        void sift_up(size_t pos)
+        {
+            const entry e = heap_[pos];
+            while (pos > 0)
+            {
+                const size_t parent = (pos - 1) / TArity;
+                if (!before(e, heap_[parent]))
+                {
+                    break;
+                }
+                move(heap_[parent], pos);
+                pos = parent;
+            }
+            move(e, pos);
+        }
+
+        void sift_down(size_t pos)
+        {
+            const entry  e    = heap_[pos];
+            const size_t size = heap_.size();
+            while (true)
+            {
+                const size_t first = pos * TArity + 1;
+                if (first >= size)
+                {
+                    break;
+                }
+
+                // children are adjacent in memory, one cache line for small keys and d = 4
+                size_t best = first;
+                const size_t end = std::min(first + TArity, size);
+                for (size_t child = first + 1; child < end; ++child)
+                {
+                    if (before(heap_[child], heap_[best]))
+                    {
+                        best = child;
+                    }
+                }
+                if (!before(heap_[best], e))
+                {
+                    break;
+                }
+                move(heap_[best], pos);
+                pos = best;
+            }
+            move(e, pos);
+        }
+
+        void release(node* n)
+        {
+            std::allocator_traits<allocator>::destroy(al_, n);
+            al_.deallocate(n, 1);
+        }
+
+        allocator          al_;
+        TProjection        projection_;
+        TCompare           compare_;
+        std::vector<entry> heap_;
+    };
+}
@@ -2,8 +2,12 @@
 
 #include <memory>
 #include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "allocator.hpp"
+#include "errors.hpp"
 
 namespace oop
 {
@@ -71,8 +75,9 @@ namespace oop
         private:
             using internal_value_type = std::unique_ptr<node, deleter>*;
 
-            forward_iterator(internal_value_type ptr)
+            forward_iterator(internal_value_type ptr, node* prev = nullptr)
                 : node_(ptr)
+                , prev_(prev)
             {}
 
         public:
@@ -87,13 +92,14 @@ namespace oop
                 {
                     throw std::out_of_range{"iterator is out of range"};
                 }
-                node_ = &(*node_)->next;
+                prev_ = node_->get();
+                node_ = &prev_->next;
                 return *this;
             }
 
             forward_iterator operator++(int)
             {
-                forward_iterator it = node_;
+                forward_iterator it = *this;
                 ++(*this);
                 return it;
             }
@@ -110,6 +116,7 @@ namespace oop
 
         private:
             internal_value_type node_;
+            node*               prev_; //!< node owning the link, nullptr for the head link
 
             friend queue;
         };
@@ -121,15 +128,36 @@ namespace oop
             , size_(0)
         {}
 
+        queue(const queue&) = delete;
+        queue& operator=(const queue&) = delete;
+
+        /*!
+         * @brief destructor
+         *
+         * Unlinks nodes one by one: letting the unique_ptr chain destroy itself recurses once per node.
+         */
+        ~queue()
+        {
+            while (first_)
+            {
+                auto free = first_->next.release();
+                first_.reset(free);
+            }
+        }
+
         void pop()
         {
             if (first_.get() == nullptr)
             {
-                throw std::out_of_range("queue is empty");
+                throw empty_queue_error{};
             }
             
             auto free = first_->next.release();
             first_.reset(free);
+            if (free == nullptr)
+            {
+                last_ = nullptr;
+            }
             --size_;
         }
 
@@ -154,11 +182,20 @@ namespace oop
         {
             if (first_.get() == nullptr)
             {
-                throw std::out_of_range("queue is empty");
+                throw empty_queue_error{};
             }
             return first_->value;
         }
 
+        [[nodiscard]] T& back()
+        {
+            if (last_ == nullptr)
+            {
+                throw empty_queue_error{};
+            }
+            return last_->value;
+        }
+
         [[nodiscard]] size_t size() const noexcept
         {
             return size_;
@@ -181,12 +218,18 @@ namespace oop
 
         void insert(forward_iterator it, const T& v)
         {
-            auto free = it.node_->release();
-            auto obj  = al_.allocate(1);
+            // allocate before touching the link, a full pool throws and leaves the queue as it was
+            auto obj = al_.allocate(1);
             std::allocator_traits<allocator>::construct(al_, obj, v, deleter_);
 
+            auto free = it.node_->release();
+            obj->next.reset(free);
             it.node_->reset(obj);
-            it.node_->get()->next.reset(free);
+            if (free == nullptr)
+            {
+                last_ = obj;
+            }
+            ++size_;
         }
 
         void erase(forward_iterator it)
@@ -197,9 +240,119 @@ namespace oop
             }
             auto free = it.node_->get()->next.release();
             it.node_->reset(free);
+            if (free == nullptr)
+            {
+                // the last node was erased, the iterator knows its predecessor
+                last_ = it.prev_;
+            }
+            --size_;
+        }
+
+        /*!
+         * @brief removes every element matching `pred` in a single pass
+         *
+         * Unlinked nodes are collected and returned to the allocator in one batch
+         * when it supports `deallocate_batch`.
+         * @return number of removed elements
+         */
+        template <typename F>
+        size_t erase_if(F&& pred)
+        {
+            return erase_if(std::forward<F>(pred), [](const T&) noexcept {});
+        }
+
+        /*!
+         * @brief removes every element matching `pred` and passes each removed one to `on_erase`
+         *
+         * `on_erase` runs after the pass, while the removed values are still alive,
+         * so `pred` can stay free of side effects. It must not throw.
+         * @return number of removed elements
+         */
+        template <typename F, typename G>
+        size_t erase_if(F&& pred, G&& on_erase)
+        {
+            std::vector<node*> garbage;
+
+            node* tail = nullptr;
+            auto* link = &first_;
+            try
+            {
+                while (*link)
+                {
+                    if (pred(static_cast<const T&>((*link)->value)))
+                    {
+                        garbage.push_back(link->get());
+                        node* dead = link->release();
+                        link->reset(dead->next.release());
+                    }
+                    else
+                    {
+                        tail = link->get();
+                        link = &tail->next;
+                    }
+                }
+            }
+            catch (...)
+            {
+                // the tail was not reached, last_ is still valid
+                size_ -= garbage.size();
+                for (node* n : garbage)
+                {
+                    on_erase(static_cast<const T&>(n->value));
+                }
+                release(garbage);
+                throw;
+            }
+            last_  = tail;
+            size_ -= garbage.size();
+
+            for (node* n : garbage)
+            {
+                on_erase(static_cast<const T&>(n->value));
+            }
+            release(garbage);
+            return garbage.size();
+        }
+
+        /*!
+         * @brief keeps only the elements matching `pred`
+         */
+        template <typename F>
+        size_t retain_if(F&& pred)
+        {
+            return erase_if([&pred](const T& v) { return !pred(v); });
         }
 
     private:
+        template <typename A, typename = void>
+        struct has_batch_deallocate : std::false_type {};
+
+        template <typename A>
+        struct has_batch_deallocate<A, std::void_t<decltype(std::declval<A&>().deallocate_batch(std::declval<node* const*>(), size_t{}))>>
+            : std::true_type {};
+
+        /*!
+         * @brief destroys unlinked nodes and gives their memory back
+         */
+        void release(std::vector<node*>& nodes)
+        {
+            for (node* n : nodes)
+            {
+                std::allocator_traits<allocator>::destroy(al_, n);
+            }
+            if constexpr (has_batch_deallocate<allocator>::value)
+            {
+                al_.deallocate_batch(nodes.data(), nodes.size());
+            }
+            else
+            {
+                for (node* n : nodes)
+                {
+                    al_.deallocate(n, 1);
+                }
+            }
+        }
+
         allocator al_;
         deleter   deleter_;
 
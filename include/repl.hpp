@@ -0,0 +1,584 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "point.hpp"
+#include "polygon.hpp"
+#include "allocator.hpp"
+#include "errors.hpp"
+#include "queue.hpp"
+#include "journal.hpp"
+#include "stats.hpp"
+#include "thread_pool.hpp"
+#include "spatial_index.hpp"
+#include "aggregate.hpp"
+#include "priority_queue.hpp"
+#include "validation.hpp"
+
+using rhombus = basic_polygon<point2d, 4>;
+
+#if !defined(OOP_POOL_SIZE)
+/*!
+ * @brief shapes each queue of the application and the tools can hold, override with -DOOP_POOL_SIZE=<n>
+ *
+ * Every queue reserves its pool up front, about 100 bytes per shape.
+ */
+#define OOP_POOL_SIZE (1 << 16)
+#endif
+
+namespace oop
+{
+    /*!
+     * @brief reads four vertices and sets failbit unless they form a non-degenerate rhombus
+     */
+    inline void read_rhombus(std::istream& in, rhombus& r)
+    {
+        constexpr double precision = 0.000000001;
+        for (auto& p : r)
+        {
+            in >> p;
+        }
+        if (in.fail())
+        {
+            return;
+        }
+
+        if (!valid_rhombus(r, precision))
+        {
+            in.setstate(std::ios::failbit);
+        }
+    }
+
+    /*!
+     * @brief command engine of the application
+     *
+     * Reads command arguments from `in` and writes results to `out`,
+     * so it can be driven by the interactive loop as well as in-process by tools.
+     */
+    template <size_t TPoolSize>
+    class basic_repl
+    {
+        static constexpr std::array<std::string_view, 17> commands = {
+            "push", "top", "pop", "insert", "erase", "print", "less", "drop_less",
+            "pq_push", "pq_top", "pq_pop",
+            "contains", "intersects", "nearest", "aggregate", "stats", "exit"
+        };
+
+    public:
+        using queue          = oop::queue<rhombus, vector_allocator<rhombus, TPoolSize>>;
+        using priority_queue = oop::priority_queue<rhombus, area_of, std::less<>, 4, vector_allocator<rhombus, TPoolSize>>;
+        using stats = command_stats<commands.size()>;
+
+        basic_repl(std::istream& in, std::ostream& out)
+            : in_(in)
+            , out_(out)
+            , stats_(commands)
+        {}
+
+        /*!
+         * @brief opens the command journal and replays it onto the queue
+         *
+         * Mutations are journaled before they are applied. A record whose command ran out of pool
+         * memory failed the same way when it was journaled, so replay skips it as well.
+         */
+        void open_journal(const std::string& path, journal_options options = {})
+        {
+            journal_.open(path, options);
+            journal_.replay([this](journal_op op, size_t ix, const rhombus* r)
+            {
+                try
+                {
+                    apply(op, ix, r);
+                }
+                catch (const std::bad_alloc&)
+                {}
+            });
+            compact_if_due();
+        }
+
+        /*!
+         * @brief replaces the journal with a snapshot of the queues
+         */
+        void compact_journal()
+        {
+            journal_.compact([this](auto&& emit)
+            {
+                for (const rhombus& r : q_)
+                {
+                    emit(journal_op::push, 0, &r);
+                }
+                pq_.for_each([&emit](const rhombus& r) { emit(journal_op::pq_push, 0, &r); });
+            });
+        }
+
+        /*!
+         * @brief rewrites `path` with the statistics report at most every `interval`
+         */
+        void dump_stats(const std::string& path, std::chrono::seconds interval)
+        {
+            stats_path_     = path;
+            stats_interval_ = interval;
+            last_dump_      = stats::clock::now();
+        }
+
+        /*!
+         * @brief sets the number of threads for whole-queue queries, 0 means one per hardware thread
+         */
+        void set_threads(size_t threads)
+        {
+            threads_ = threads;
+            pool_.reset();
+        }
+
+        /*!
+         * @brief executes a single command
+         *
+         * Errors are reported to the output stream.
+         * @return false when the command asks to stop the session
+         */
+        bool execute(const std::string& input)
+        {
+            const auto start = stats::clock::now();
+
+            bool go = true;
+            try {
+                go = dispatch(input);
+            }
+            catch (std::exception & e)
+            {
+                stats_.record_error(e);
+                out_ << "error: " << e.what() << std::endl;
+            }
+
+            const auto finish = stats::clock::now();
+            stats_.record(stats_.command_index(input), finish - start);
+            stats_.record_size(q_.size());
+
+            if (!stats_path_.empty() && finish - last_dump_ >= stats_interval_)
+            {
+                std::ofstream file{ stats_path_, std::ios::trunc };
+                stats_.write(file);
+                last_dump_ = finish;
+            }
+            return go;
+        }
+
+        [[nodiscard]] queue& get_queue() noexcept
+        {
+            return q_;
+        }
+
+        [[nodiscard]] priority_queue& get_priority_queue() noexcept
+        {
+            return pq_;
+        }
+
+        [[nodiscard]] const stats& get_stats() const noexcept
+        {
+            return stats_;
+        }
+
+    private:
+        bool dispatch(const std::string& input)
+        {
+            if (input == "push")
+            {
+                rhombus r;
+                read(r);
+                journal_.push(r);
+                apply(journal_op::push, 0, &r);
+            }
+            else if (input == "top")
+            {
+                rhombus& r = q_.top();
+                print2d(out_, r);
+            }
+            else if (input == "pop")
+            {
+                check(journal_op::pop, 0);
+                journal_.pop();
+                apply(journal_op::pop, 0, nullptr);
+            }
+            else if (input == "insert")
+            {
+                size_t ix;
+                rhombus r;
+                in_ >> ix;
+                read(r);
+
+                check(journal_op::insert, ix);
+                journal_.insert(ix, r);
+                apply(journal_op::insert, ix, &r);
+            }
+            else if (input == "erase")
+            {
+                size_t ix;
+                in_ >> ix;
+                check_arguments();
+
+                check(journal_op::erase, ix);
+                journal_.erase(ix);
+                apply(journal_op::erase, ix, nullptr);
+            }
+            else if (input == "print")
+            {
+                print_matching(true, [](const rhombus&) { return true; });
+            }
+            else if (input == "less")
+            {
+                double area;
+                in_ >> area;
+                check_arguments();
+                if (area < 0)
+                {
+                    out_ << "invalid area" << std::endl;
+                    return true;
+                }
+
+                print_matching(false, [area](const rhombus& r) { return area2d(r) < area; });
+            }
+            else if (input == "drop_less")
+            {
+                double area;
+                in_ >> area;
+                if (in_.fail() || area < 0)
+                {
+                    in_.clear();
+                    out_ << "invalid area" << std::endl;
+                    return true;
+                }
+
+                journal_.drop_less(area);
+                const size_t dropped = drop_less(area);
+                out_ << "dropped: " << dropped << std::endl;
+            }
+            else if (input == "pq_push")
+            {
+                rhombus r;
+                read(r);
+                journal_.pq_push(r);
+                apply(journal_op::pq_push, 0, &r);
+            }
+            else if (input == "pq_top")
+            {
+                print2d(out_, pq_.top());
+            }
+            else if (input == "pq_pop")
+            {
+                check(journal_op::pq_pop, 0);
+                journal_.pq_pop();
+                apply(journal_op::pq_pop, 0, nullptr);
+            }
+            else if (input == "contains")
+            {
+                point2d p;
+                in_ >> p;
+                check_arguments();
+
+                index_.contains(p, [this](const rhombus* r) { print2d(out_, *r); });
+            }
+            else if (input == "intersects")
+            {
+                point2d a, b;
+                in_ >> a >> b;
+                check_arguments();
+
+                const box2d box{ { { std::min(a[0], b[0]), std::min(a[1], b[1]) } },
+                                 { { std::max(a[0], b[0]), std::max(a[1], b[1]) } } };
+                index_.intersects(box, [this](const rhombus* r) { print2d(out_, *r); });
+            }
+            else if (input == "nearest")
+            {
+                point2d p;
+                size_t  k;
+                in_ >> p >> k;
+                check_arguments();
+
+                for (const auto& [d, r] : index_.nearest(p, k))
+                {
+                    out_ << "\ndistance: " << d << std::endl;
+                    print2d(out_, *r);
+                }
+            }
+            else if (input == "aggregate")
+            {
+                aggregate_.write(out_);
+            }
+            else if (input == "stats")
+            {
+                stats_.write(out_);
+            }
+            else if (input == "exit")
+            {
+                return false;
+            }
+            else
+            {
+                out_ << "Unknown command '" << input << "'" << std::endl;
+                return true;
+            }
+            compact_if_due();
+            return true;
+        }
+
+        /*!
+         * @brief prints every rhombus accepted by `match` in queue order
+         *
+         * Large queues are split into chunks which are filtered and formatted on the thread pool,
+         * then written out in the original order.
+         */
+        template <typename F>
+        void print_matching(bool numbered, F&& match)
+        {
+            const auto print = [numbered, &match](std::ostream& out, const rhombus& r, size_t i)
+            {
+                if (!match(r))
+                {
+                    return;
+                }
+                if (numbered)
+                {
+                    out << "[-- " << i << " --]\n\n";
+                }
+                print2d(out, r);
+            };
+
+            if (q_.size() < parallel_threshold)
+            {
+                size_t i = 0;
+                for (auto& r : q_)
+                {
+                    print(out_, r, i++);
+                }
+                return;
+            }
+
+            if (!pool_)
+            {
+                pool_ = std::make_unique<thread_pool>(threads_);
+            }
+            const size_t size   = q_.size();
+            const size_t chunks = std::min(size / (parallel_threshold / 4), pool_->size() * 4);
+            const auto   bound  = [size, chunks](size_t chunk) { return size * chunk / chunks; };
+
+            // a single walk over the queue: every chunk is submitted as soon as the walk reaches it
+            std::vector<std::string> parts(chunks);
+            auto it = q_.begin();
+            pool_->parallel_for(chunks,
+                [&](size_t chunk)
+                {
+                    const auto first = it;
+                    if (chunk + 1 < chunks)
+                    {
+                        std::advance(it, bound(chunk + 1) - bound(chunk));
+                    }
+                    return first;
+                },
+                [&](size_t chunk, typename queue::forward_iterator first)
+                {
+                    std::ostringstream out;
+                    out.flags(out_.flags());
+                    out.precision(out_.precision());
+                    out.fill(out_.fill());
+                    for (size_t i = bound(chunk); i < bound(chunk + 1); ++i, ++first)
+                    {
+                        print(out, *first, i);
+                    }
+                    parts[chunk] = out.str();
+                });
+
+            for (const auto& part : parts)
+            {
+                out_ << part;
+            }
+        }
+
+        /*!
+         * @brief reads a rhombus and recovers the stream when it is invalid
+         */
+        void read(rhombus& r)
+        {
+            read_rhombus(in_, r);
+            if (in_.fail())
+            {
+                in_.clear();
+                throw bad_polygon_error{};
+            }
+        }
+
+        /*!
+         * @brief recovers the stream when query arguments could not be read
+         */
+        void check_arguments()
+        {
+            if (in_.fail())
+            {
+                in_.clear();
+                throw std::invalid_argument{"bad arguments"};
+            }
+        }
+
+        /*!
+         * @brief throws when the mutation can not be applied, before anything is journaled
+         */
+        void check(const journal_op op, const size_t ix) const
+        {
+            switch (op)
+            {
+            case journal_op::pop:
+                if (q_.size() == 0)
+                {
+                    throw empty_queue_error{};
+                }
+                break;
+            case journal_op::insert:
+                if (ix > q_.size())
+                {
+                    throw std::out_of_range{"insert iterator is out of range"};
+                }
+                break;
+            case journal_op::erase:
+                if (ix >= q_.size())
+                {
+                    throw std::out_of_range{"erase iterator is out of range"};
+                }
+                break;
+            case journal_op::pq_pop:
+                if (pq_.empty())
+                {
+                    throw empty_queue_error{};
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        /*!
+         * @brief compacts once the journal holds several times more records than a snapshot would
+         */
+        void compact_if_due()
+        {
+            if (journal_.is_open() && journal_.records() > 4 * (q_.size() + pq_.size()) + compaction_slack)
+            {
+                compact_journal();
+            }
+        }
+
+        typename queue::forward_iterator iterator_at(size_t ix)
+        {
+            auto it = q_.begin();
+            while (ix > 0)
+            {
+                ++it;
+                --ix;
+            }
+            return it;
+        }
+
+        /*!
+         * @brief erases every rhombus with area below `area` in a single pass
+         */
+        size_t drop_less(double area)
+        {
+            return q_.erase_if([area](const rhombus& r) { return area2d(r) < area; },
+                [this](const rhombus& r)
+                {
+                    index_.erase(&r);
+                    aggregate_.erase(r);
+                });
+        }
+
+        /*!
+         * @brief applies a mutation to the queues and keeps the spatial index and the aggregates in sync
+         *
+         * The index refers to rhombi by address, nodes of the queue never move.
+         */
+        void apply(const journal_op op, const size_t ix, const rhombus* r)
+        {
+            switch (op)
+            {
+            case journal_op::push:
+                q_.push(*r);
+                index_.insert(&q_.back());
+                aggregate_.insert(*r);
+                break;
+            case journal_op::pop:
+            {
+                const rhombus* top = &q_.top();
+                aggregate_.erase(*top);
+                index_.erase(top);
+                q_.pop();
+                break;
+            }
+            case journal_op::insert:
+            {
+                auto it = iterator_at(ix);
+                q_.insert(it, *r);
+                index_.insert(&*it);
+                aggregate_.insert(*r);
+                break;
+            }
+            case journal_op::erase:
+            {
+                if (ix >= q_.size())
+                {
+                    throw std::out_of_range{"erase iterator is out of range"};
+                }
+                auto it = iterator_at(ix);
+                aggregate_.erase(*it);
+                index_.erase(&*it);
+                q_.erase(it);
+                break;
+            }
+            case journal_op::drop_less:
+            {
+                const std::uint64_t bits = ix;
+                double area;
+                std::memcpy(&area, &bits, sizeof(area));
+                drop_less(area);
+                break;
+            }
+            case journal_op::pq_push:
+                pq_.push(*r);
+                break;
+            case journal_op::pq_pop:
+                pq_.pop();
+                break;
+            }
+        }
+
+        std::istream&    in_;
+        std::ostream&    out_;
+        queue            q_;
+        journal<rhombus> journal_;
+
+        spatial_index<rhombus>     index_;
+        running_aggregate<rhombus> aggregate_;
+
+        priority_queue pq_;
+
+        static constexpr size_t parallel_threshold = 1 << 12;
+        static constexpr size_t compaction_slack   = 1 << 12;
+
+        size_t                       threads_ = 0;
+        std::unique_ptr<thread_pool> pool_;
+
+        stats                       stats_;
+        std::string                 stats_path_;
+        std::chrono::seconds        stats_interval_{};
+        stats::clock::time_point    last_dump_;
+    };
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "errors.hpp"
+#include "point.hpp"
+#include "polygon.hpp"
+
+namespace oop
+{
+    /*!
+     * @brief ordered store of polygons with different compile-time vertex counts
+     *
+     * Every arity gets its own contiguous pool with a free-slot list, the global order
+     * is kept in a compact index of (kind, slot) entries. Per-arity operations are
+     * dispatched through jump tables generated at compile time, there is no virtual call.
+     */
+    template <typename TVertex, size_t... TArities>
+    class shape_store
+    {
+        static_assert(sizeof...(TArities) > 0, "shape_store needs at least one arity");
+        static_assert(sizeof...(TArities) <= UINT8_MAX, "too many arities");
+
+    public:
+        using vertex = TVertex;
+
+        template <size_t N>
+        using polygon = basic_polygon<TVertex, N>;
+
+        static constexpr size_t kinds = sizeof...(TArities);
+        static constexpr std::array<size_t, kinds> arities = { TArities... };
+
+    private:
+        struct entry
+        {
+            std::uint8_t  kind;
+            std::uint32_t slot;
+        };
+
+        template <size_t N>
+        struct pool
+        {
+            std::vector<polygon<N>>    items;
+            std::vector<std::uint32_t> free;
+        };
+
+        template <size_t N>
+        static constexpr size_t kind_of() noexcept
+        {
+            size_t k = 0;
+            while (k < kinds && arities[k] != N)
+            {
+                ++k;
+            }
+            return k;
+        }
+
+        template <size_t K>
+        static constexpr size_t arity_of = arities[K];
+
+    public:
+        using area_type   = decltype(area2d(std::declval<const polygon<arity_of<0>>&>()));
+        using center_type = decltype(center2d(std::declval<const polygon<arity_of<0>>&>()));
+
+    private:
+        using area_fn   = area_type (*)(const shape_store&, std::uint32_t);
+        using center_fn = center_type (*)(const shape_store&, std::uint32_t);
+        using erase_fn  = void (*)(shape_store&, std::uint32_t);
+
+    public:
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return order_.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return order_.empty();
+        }
+
+        template <size_t N>
+        void push(const polygon<N>& p)
+        {
+            order_.push_back(store(p));
+        }
+
+        template <size_t N>
+        void insert(size_t ix, const polygon<N>& p)
+        {
+            check(ix, order_.size() + 1);
+            order_.insert(order_.begin() + static_cast<std::ptrdiff_t>(ix), store(p));
+        }
+
+        void pop()
+        {
+            if (order_.empty())
+            {
+                throw empty_queue_error{};
+            }
+            release(order_.front());
+            order_.pop_front();
+        }
+
+        void erase(size_t ix)
+        {
+            check(ix, order_.size());
+            release(order_[ix]);
+            order_.erase(order_.begin() + static_cast<std::ptrdiff_t>(ix));
+        }
+
+        /*!
+         * @brief vertex count of the ix-th polygon
+         */
+        [[nodiscard]] size_t arity(size_t ix) const
+        {
+            check(ix, order_.size());
+            return arities[order_[ix].kind];
+        }
+
+        [[nodiscard]] area_type area(size_t ix) const
+        {
+            check(ix, order_.size());
+            const entry e = order_[ix];
+            static constexpr auto table = make_area_table(std::make_index_sequence<kinds>{});
+            return table[e.kind](*this, e.slot);
+        }
+
+        [[nodiscard]] center_type center(size_t ix) const
+        {
+            check(ix, order_.size());
+            const entry e = order_[ix];
+            static constexpr auto table = make_center_table(std::make_index_sequence<kinds>{});
+            return table[e.kind](*this, e.slot);
+        }
+
+        /*!
+         * @brief calls f(polygon) with the ix-th polygon in its concrete type
+         */
+        template <typename F>
+        decltype(auto) visit(size_t ix, F&& f) const
+        {
+            check(ix, order_.size());
+            const entry e = order_[ix];
+            return visit_table<F>::value[e.kind](*this, e.slot, f);
+        }
+
+        /*!
+         * @brief calls f(polygon) for every polygon in insertion order
+         */
+        template <typename F>
+        void for_each(F&& f) const
+        {
+            for (const entry e : order_)
+            {
+                visit_table<F>::value[e.kind](*this, e.slot, f);
+            }
+        }
+
+        /*!
+         * @brief number of stored polygons with N vertices
+         */
+        template <size_t N>
+        [[nodiscard]] size_t count() const noexcept
+        {
+            const auto& p = std::get<kind_of<N>()>(pools_);
+            return p.items.size() - p.free.size();
+        }
+
+    private:
+        template <size_t N>
+        entry store(const polygon<N>& p)
+        {
+            constexpr size_t kind = kind_of<N>();
+            static_assert(kind < kinds, "arity is not supported by this store");
+
+            auto& pool = std::get<kind>(pools_);
+            std::uint32_t slot;
+            if (!pool.free.empty())
+            {
+                slot = pool.free.back();
+                pool.free.pop_back();
+                pool.items[slot] = p;
+            }
+            else
+            {
+                if (pool.items.size() >= UINT32_MAX)
+                {
+                    throw std::length_error{"shape_store: pool is full"};
+                }
+                slot = static_cast<std::uint32_t>(pool.items.size());
+                pool.items.push_back(p);
+            }
+            return { static_cast<std::uint8_t>(kind), slot };
+        }
+
+        void release(entry e)
+        {
+            static constexpr auto table = make_erase_table(std::make_index_sequence<kinds>{});
+            table[e.kind](*this, e.slot);
+        }
+
+        static void check(size_t ix, size_t bound)
+        {
+            if (ix >= bound)
+            {
+                throw std::out_of_range{"shape_store: index is out of range"};
+            }
+        }
+
+        template <size_t K>
+        const polygon<arity_of<K>>& get(std::uint32_t slot) const noexcept
+        {
+            return std::get<K>(pools_).items[slot];
+        }
+
+        // jump tables
+
+        template <size_t K>
+        static area_type area_of(const shape_store& s, std::uint32_t slot)
+        {
+            return area2d(s.get<K>(slot));
+        }
+
+        template <size_t K>
+        static center_type center_of(const shape_store& s, std::uint32_t slot)
+        {
+            return center2d(s.get<K>(slot));
+        }
+
+        template <size_t K>
+        static void erase_of(shape_store& s, std::uint32_t slot)
+        {
+            std::get<K>(s.pools_).free.push_back(slot);
+        }
+
+        template <size_t... K>
+        static constexpr std::array<area_fn, kinds> make_area_table(std::index_sequence<K...>) noexcept
+        {
+            return { &area_of<K>... };
+        }
+
+        template <size_t... K>
+        static constexpr std::array<center_fn, kinds> make_center_table(std::index_sequence<K...>) noexcept
+        {
+            return { &center_of<K>... };
+        }
+
+        template <size_t... K>
+        static constexpr std::array<erase_fn, kinds> make_erase_table(std::index_sequence<K...>) noexcept
+        {
+            return { &erase_of<K>... };
+        }
+
+        template <typename F>
+        struct visit_table
+        {
+            using result = decltype(std::declval<F&>()(std::declval<const polygon<arity_of<0>>&>()));
+            using fn     = result (*)(const shape_store&, std::uint32_t, F&);
+
+            template <size_t K>
+            static result call(const shape_store& s, std::uint32_t slot, F& f)
+            {
+                return f(s.get<K>(slot));
+            }
+
+            template <size_t... K>
+            static constexpr std::array<fn, kinds> make(std::index_sequence<K...>) noexcept
+            {
+                return { &call<K>... };
+            }
+
+            static constexpr std::array<fn, kinds> value = make(std::make_index_sequence<kinds>{});
+        };
+
+        std::tuple<pool<TArities>...> pools_;
+        std::deque<entry>             order_;
+    };
+}
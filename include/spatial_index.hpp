@@ -0,0 +1,648 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "point.hpp"
+
+namespace oop
+{
+    /*!
+     * @brief axis-aligned box
+     */
+    struct box2d
+    {
+        point2d min;
+        point2d max;
+
+        [[nodiscard]] constexpr bool contains(const point2d& p) const noexcept
+        {
+            return min[0] <= p[0] && p[0] <= max[0] && min[1] <= p[1] && p[1] <= max[1];
+        }
+
+        [[nodiscard]] constexpr bool intersects(const box2d& other) const noexcept
+        {
+            return min[0] <= other.max[0] && other.min[0] <= max[0]
+                && min[1] <= other.max[1] && other.min[1] <= max[1];
+        }
+    };
+
+    namespace detail
+    {
+        template <typename T, size_t... Ix>
+        constexpr std::array<point2d, sizeof...(Ix)> vertices(const T& shape, std::index_sequence<Ix...>)
+        {
+            using std::get;
+            return { get<Ix>(shape)... };
+        }
+
+        template <typename T>
+        constexpr auto vertices(const T& shape)
+        {
+            return vertices(shape, std::make_index_sequence<std::tuple_size_v<T>>{});
+        }
+
+        template <size_t N>
+        box2d bounds(const std::array<point2d, N>& v) noexcept
+        {
+            box2d b{ v[0], v[0] };
+            for (const auto& p : v)
+            {
+                b.min[0] = std::min(b.min[0], p[0]);
+                b.min[1] = std::min(b.min[1], p[1]);
+                b.max[0] = std::max(b.max[0], p[0]);
+                b.max[1] = std::max(b.max[1], p[1]);
+            }
+            return b;
+        }
+
+        /*!
+         * @brief crossing number test, points on the boundary may go either way
+         */
+        template <size_t N>
+        bool inside(const std::array<point2d, N>& v, const point2d& p) noexcept
+        {
+            bool result = false;
+            for (size_t i = 0, j = N - 1; i < N; j = i++)
+            {
+                if ((v[i][1] > p[1]) != (v[j][1] > p[1])
+                    && p[0] < (v[j][0] - v[i][0]) * (p[1] - v[i][1]) / (v[j][1] - v[i][1]) + v[i][0])
+                {
+                    result = !result;
+                }
+            }
+            return result;
+        }
+
+        inline double cross(const point2d& o, const point2d& a, const point2d& b) noexcept
+        {
+            return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0]);
+        }
+
+        inline bool segments_intersect(const point2d& a, const point2d& b, const point2d& c, const point2d& d) noexcept
+        {
+            const double d1 = cross(c, d, a);
+            const double d2 = cross(c, d, b);
+            const double d3 = cross(a, b, c);
+            const double d4 = cross(a, b, d);
+            if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+            {
+                return true;
+            }
+
+            const auto on_segment = [](const point2d& p, const point2d& q, const point2d& r)
+            {
+                return std::min(p[0], q[0]) <= r[0] && r[0] <= std::max(p[0], q[0])
+                    && std::min(p[1], q[1]) <= r[1] && r[1] <= std::max(p[1], q[1]);
+            };
+            return (d1 == 0 && on_segment(c, d, a)) || (d2 == 0 && on_segment(c, d, b))
+                || (d3 == 0 && on_segment(a, b, c)) || (d4 == 0 && on_segment(a, b, d));
+        }
+
+        template <size_t N>
+        bool intersects(const std::array<point2d, N>& v, const box2d& b) noexcept
+        {
+            const std::array<point2d, 4> corners = {
+                b.min, point2d{ { b.max[0], b.min[1] } }, b.max, point2d{ { b.min[0], b.max[1] } }
+            };
+            for (const auto& p : v)
+            {
+                if (b.contains(p))
+                {
+                    return true;
+                }
+            }
+            if (inside(v, corners[0]))
+            {
+                return true;
+            }
+            for (size_t i = 0, j = N - 1; i < N; j = i++)
+            {
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    if (segments_intersect(v[j], v[i], corners[k], corners[(k + 1) % 4]))
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        inline double segment_distance(const point2d& a, const point2d& b, const point2d& p) noexcept
+        {
+            const point2d ab = b - a;
+            const point2d ap = p - a;
+            const double  length = ab[0] * ab[0] + ab[1] * ab[1];
+            const double  t = length > 0 ? std::clamp((ap[0] * ab[0] + ap[1] * ab[1]) / length, 0.0, 1.0) : 0.0;
+            const point2d closest{ { a[0] + t * ab[0], a[1] + t * ab[1] } };
+            return ::distance(closest, p);
+        }
+
+        /*!
+         * @brief distance from p to the polygon area, 0 inside
+         */
+        template <size_t N>
+        double distance(const std::array<point2d, N>& v, const point2d& p) noexcept
+        {
+            if (inside(v, p))
+            {
+                return 0;
+            }
+            double result = std::numeric_limits<double>::infinity();
+            for (size_t i = 0, j = N - 1; i < N; j = i++)
+            {
+                result = std::min(result, segment_distance(v[j], v[i], p));
+            }
+            return result;
+        }
+    }
+
+    /*!
+     * @brief grids over bounding boxes of externally owned polygons
+     *
+     * Shapes are registered by address, so the owner must erase a shape before it moves or dies.
+     * Every shape is listed in each cell its bounding box touches, on the finest of `levels` grids
+     * where that is at most `max_cells` cells. Each level has cells `level_factor` times wider than
+     * the one below, only shapes too large for the coarsest level go to a list that every query checks.
+     * Queries filter candidates by bounding box and run exact polygon tests on the rest.
+     * Cell coordinates are clamped to 32 bits, far away shapes share the border cells.
+     *
+     * nearest() refreshes the cached extent of a level after erasures, so queries are not safe
+     * to run concurrently with each other.
+     */
+    template <typename T>
+    class spatial_index
+    {
+        using cell_key = std::uint64_t;
+        using cell_map = std::unordered_map<cell_key, std::vector<const T*>>;
+        using range    = std::pair<std::int64_t, std::int64_t>;
+
+        /*!
+         * @brief one level, its occupied extent is recomputed lazily once a cell on its border empties
+         */
+        struct grid
+        {
+            double        cell_size;
+            cell_map      cells;
+            mutable range extent_x{ INT64_MAX, INT64_MIN };
+            mutable range extent_y{ INT64_MAX, INT64_MIN };
+            mutable bool  stale = false;
+        };
+
+        struct entry
+        {
+            box2d        box;
+            std::uint8_t level;
+        };
+
+    public:
+        static constexpr size_t max_cells    = 64;
+        static constexpr size_t levels       = 4;
+        static constexpr double level_factor = 16;
+
+        explicit spatial_index(double cell_size = 32)
+        {
+            if (!(cell_size > 0))
+            {
+                throw std::invalid_argument{"spatial_index: bad cell size"};
+            }
+            for (auto& g : grids_)
+            {
+                g.cell_size = cell_size;
+                cell_size *= level_factor;
+            }
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return shapes_.size();
+        }
+
+        void insert(const T* shape)
+        {
+            const box2d box = detail::bounds(detail::vertices(*shape));
+            if (!std::isfinite(box.min[0]) || !std::isfinite(box.min[1])
+                || !std::isfinite(box.max[0]) || !std::isfinite(box.max[1]))
+            {
+                throw std::invalid_argument{"spatial_index: coordinates are not finite"};
+            }
+
+            size_t       level = 0;
+            std::int64_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+            for (; level < levels; ++level)
+            {
+                std::tie(x0, y0) = cell_of(grids_[level], box.min);
+                std::tie(x1, y1) = cell_of(grids_[level], box.max);
+                if (cell_count(x0, y0, x1, y1) <= max_cells)
+                {
+                    break;
+                }
+            }
+            if (!shapes_.emplace(shape, entry{ box, static_cast<std::uint8_t>(level) }).second)
+            {
+                throw std::invalid_argument{"spatial_index: shape is already indexed"};
+            }
+
+            if (level == levels)
+            {
+                oversized_.push_back(shape);
+                return;
+            }
+            grid& g = grids_[level];
+            for (auto x = x0; x <= x1; ++x)
+            {
+                for (auto y = y0; y <= y1; ++y)
+                {
+                    g.cells[key(x, y)].push_back(shape);
+                }
+            }
+            g.extent_x = { std::min(g.extent_x.first, x0), std::max(g.extent_x.second, x1) };
+            g.extent_y = { std::min(g.extent_y.first, y0), std::max(g.extent_y.second, y1) };
+        }
+
+        void erase(const T* shape)
+        {
+            const auto it = shapes_.find(shape);
+            if (it == shapes_.end())
+            {
+                return;
+            }
+            const entry e = it->second;
+            shapes_.erase(it);
+
+            if (e.level == levels)
+            {
+                remove(oversized_, shape);
+                return;
+            }
+
+            grid& g = grids_[e.level];
+            const auto [x0, y0] = cell_of(g, e.box.min);
+            const auto [x1, y1] = cell_of(g, e.box.max);
+            for (auto x = x0; x <= x1; ++x)
+            {
+                for (auto y = y0; y <= y1; ++y)
+                {
+                    const auto cell = g.cells.find(key(x, y));
+                    remove(cell->second, shape);
+                    if (cell->second.empty())
+                    {
+                        g.cells.erase(cell);
+                        g.stale = g.stale || x == g.extent_x.first || x == g.extent_x.second
+                                          || y == g.extent_y.first || y == g.extent_y.second;
+                    }
+                }
+            }
+        }
+
+        /*!
+         * @brief calls out(shape) for every shape containing p
+         */
+        template <typename F>
+        void contains(const point2d& p, F&& out) const
+        {
+            const auto visit = [&](const T* shape)
+            {
+                if (shapes_.at(shape).box.contains(p) && detail::inside(detail::vertices(*shape), p))
+                {
+                    out(shape);
+                }
+            };
+
+            for (const grid& g : grids_)
+            {
+                if (g.cells.empty())
+                {
+                    continue;
+                }
+                const auto [x, y] = cell_of(g, p);
+                if (const auto cell = g.cells.find(key(x, y)); cell != g.cells.end())
+                {
+                    std::for_each(cell->second.begin(), cell->second.end(), visit);
+                }
+            }
+            std::for_each(oversized_.begin(), oversized_.end(), visit);
+        }
+
+        /*!
+         * @brief calls out(shape) once for every shape intersecting the box
+         */
+        template <typename F>
+        void intersects(const box2d& query, F&& out) const
+        {
+            const auto check = [&](const T* shape, const box2d& box)
+            {
+                if (box.intersects(query) && detail::intersects(detail::vertices(*shape), query))
+                {
+                    out(shape);
+                }
+            };
+
+            for (const grid& g : grids_)
+            {
+                if (g.cells.empty())
+                {
+                    continue;
+                }
+                const auto [x0, y0] = cell_of(g, query.min);
+                const auto [x1, y1] = cell_of(g, query.max);
+
+                const auto visit = [&](std::int64_t x, std::int64_t y, const std::vector<const T*>& shapes)
+                {
+                    for (const T* shape : shapes)
+                    {
+                        // report a shape only from the first cell of its overlap with the query
+                        const box2d& box = shapes_.at(shape).box;
+                        const auto [fx, fy] = cell_of(g, point2d{ { std::max(box.min[0], query.min[0]), std::max(box.min[1], query.min[1]) } });
+                        if (fx == x && fy == y)
+                        {
+                            check(shape, box);
+                        }
+                    }
+                };
+
+                if (cell_count(x0, y0, x1, y1) > g.cells.size())
+                {
+                    // a query wider than the populated grid is cheaper as a walk over the populated cells
+                    for (const auto& [k, shapes] : g.cells)
+                    {
+                        const auto [x, y] = cell_at(k);
+                        if (x0 <= x && x <= x1 && y0 <= y && y <= y1)
+                        {
+                            visit(x, y, shapes);
+                        }
+                    }
+                    continue;
+                }
+
+                for (auto x = x0; x <= x1; ++x)
+                {
+                    for (auto y = y0; y <= y1; ++y)
+                    {
+                        if (const auto cell = g.cells.find(key(x, y)); cell != g.cells.end())
+                        {
+                            visit(x, y, cell->second);
+                        }
+                    }
+                }
+            }
+            for (const T* shape : oversized_)
+            {
+                check(shape, shapes_.at(shape).box);
+            }
+        }
+
+        /*!
+         * @brief up to k shapes closest to p, closest first
+         */
+        [[nodiscard]] std::vector<std::pair<double, const T*>> nearest(const point2d& p, size_t k) const
+        {
+            std::vector<std::pair<double, const T*>> found;
+            if (k == 0 || shapes_.empty())
+            {
+                return found;
+            }
+
+            std::unordered_set<const T*> seen;
+            const auto consider = [&](const T* shape)
+            {
+                if (seen.insert(shape).second)
+                {
+                    found.emplace_back(detail::distance(detail::vertices(*shape), p), shape);
+                }
+            };
+            std::for_each(oversized_.begin(), oversized_.end(), consider);
+
+            constexpr double limit = std::numeric_limits<std::int32_t>::max();
+            if (!(std::abs(p[0] / grids_[0].cell_size) < limit && std::abs(p[1] / grids_[0].cell_size) < limit))
+            {
+                // outside the clamped grid cell distances are no lower bound, NaN ends up here as well
+                for (const auto& e : shapes_)
+                {
+                    consider(e.first);
+                }
+                return finish(std::move(found), k);
+            }
+
+            // the finest level first, its candidates bound the search on the coarser ones
+            for (const grid& g : grids_)
+            {
+                if (!g.cells.empty())
+                {
+                    nearest_in(g, p, k, found, consider);
+                }
+            }
+            return finish(std::move(found), k);
+        }
+
+    private:
+        /*!
+         * @brief walks rings of cells around p until the k-th candidate is closer than any unseen shape of the level
+         */
+        template <typename F>
+        void nearest_in(const grid& g, const point2d& p, size_t k, std::vector<std::pair<double, const T*>>& found, F& consider) const
+        {
+            const auto by_distance = [](const auto& l, const auto& r) { return l.first < r.first; };
+            const auto kth_within  = [&](double bound)
+            {
+                if (found.size() < k)
+                {
+                    return false;
+                }
+                std::nth_element(found.begin(), found.begin() + static_cast<std::ptrdiff_t>(k - 1), found.end(), by_distance);
+                return found[k - 1].first <= bound;
+            };
+            // distance from p to the cells [x0, x1] x [y0, y1]
+            const auto cells_distance = [&](std::int64_t x0, std::int64_t x1, std::int64_t y0, std::int64_t y1)
+            {
+                const double dx = std::max({ static_cast<double>(x0) * g.cell_size - p[0], 0.0, p[0] - static_cast<double>(x1 + 1) * g.cell_size });
+                const double dy = std::max({ static_cast<double>(y0) * g.cell_size - p[1], 0.0, p[1] - static_cast<double>(y1 + 1) * g.cell_size });
+                return std::hypot(dx, dy);
+            };
+
+            refresh_extent(g);
+            const auto [ex0, ex1] = g.extent_x;
+            const auto [ey0, ey1] = g.extent_y;
+
+            const auto [cx, cy] = cell_of(g, p);
+            const auto visit = [&](std::int64_t x, std::int64_t y)
+            {
+                if (const auto cell = g.cells.find(key(x, y)); cell != g.cells.end())
+                {
+                    std::for_each(cell->second.begin(), cell->second.end(), consider);
+                }
+            };
+
+            const auto length = [](std::int64_t first, std::int64_t last)
+            {
+                return static_cast<size_t>(std::max<std::int64_t>(last - first + 1, 0));
+            };
+
+            // rings closer than the occupied extent are empty, only the part of a ring inside it is visited
+            size_t visited = 0;
+            for (std::int64_t ring = std::max({ std::int64_t{ 0 }, ex0 - cx, cx - ex1, ey0 - cy, cy - ey1 });; ++ring)
+            {
+                const std::int64_t bx0 = cx - ring, bx1 = cx + ring;
+                const std::int64_t by0 = cy - ring, by1 = cy + ring;
+                const std::int64_t x0  = std::max(bx0, ex0), x1 = std::min(bx1, ex1);
+                const std::int64_t y0  = std::max(by0 + 1, ey0), y1 = std::min(by1 - 1, ey1);
+
+                // the part of the ring inside the extent: rows y = by0, by1 and columns x = bx0, bx1 without corners
+                const bool row0 = ey0 <= by0 && by0 <= ey1;
+                const bool row1 = ring > 0 && ey0 <= by1 && by1 <= ey1;
+                const bool col0 = ring > 0 && ex0 <= bx0 && bx0 <= ex1;
+                const bool col1 = ring > 0 && ex0 <= bx1 && bx1 <= ex1;
+                visited += (row0 + row1) * length(x0, x1) + (col0 + col1) * length(y0, y1);
+                if (visited > g.cells.size())
+                {
+                    // a sparse extent: looking at every shape of the level is cheaper than walking empty cells
+                    for (const auto& cell : g.cells)
+                    {
+                        std::for_each(cell.second.begin(), cell.second.end(), consider);
+                    }
+                    return;
+                }
+
+                for (auto x = x0; x <= x1; ++x)
+                {
+                    if (row0)
+                    {
+                        visit(x, by0);
+                    }
+                    if (row1)
+                    {
+                        visit(x, by1);
+                    }
+                }
+                for (auto y = y0; y <= y1; ++y)
+                {
+                    if (col0)
+                    {
+                        visit(bx0, y);
+                    }
+                    if (col1)
+                    {
+                        visit(bx1, y);
+                    }
+                }
+
+                // unseen shapes lie in the part of the extent outside the square of visited rings
+                double bound = std::numeric_limits<double>::infinity();
+                if (ex0 < bx0)
+                {
+                    bound = std::min(bound, cells_distance(ex0, bx0 - 1, ey0, ey1));
+                }
+                if (ex1 > bx1)
+                {
+                    bound = std::min(bound, cells_distance(bx1 + 1, ex1, ey0, ey1));
+                }
+                if (ey0 < by0)
+                {
+                    bound = std::min(bound, cells_distance(ex0, ex1, ey0, by0 - 1));
+                }
+                if (ey1 > by1)
+                {
+                    bound = std::min(bound, cells_distance(ex0, ex1, by1 + 1, ey1));
+                }
+                if (bound == std::numeric_limits<double>::infinity() || kth_within(bound))
+                {
+                    return;
+                }
+            }
+        }
+
+        /*!
+         * @brief recomputes the extent of a level after a cell on its border emptied
+         */
+        static void refresh_extent(const grid& g)
+        {
+            if (!g.stale)
+            {
+                return;
+            }
+            range x{ INT64_MAX, INT64_MIN };
+            range y{ INT64_MAX, INT64_MIN };
+            for (const auto& cell : g.cells)
+            {
+                const auto [cx, cy] = cell_at(cell.first);
+                x = { std::min(x.first, cx), std::max(x.second, cx) };
+                y = { std::min(y.first, cy), std::max(y.second, cy) };
+            }
+            g.extent_x = x;
+            g.extent_y = y;
+            g.stale    = false;
+        }
+
+        /*!
+         * @brief k closest of the candidates, closest first
+         */
+        static std::vector<std::pair<double, const T*>> finish(std::vector<std::pair<double, const T*>> found, size_t k)
+        {
+            std::sort(found.begin(), found.end(), [](const auto& l, const auto& r) { return l.first < r.first; });
+            if (found.size() > k)
+            {
+                found.resize(k);
+            }
+            return found;
+        }
+
+        static std::pair<std::int64_t, std::int64_t> cell_of(const grid& g, const point2d& p) noexcept
+        {
+            return { to_cell(p[0] / g.cell_size), to_cell(p[1] / g.cell_size) };
+        }
+
+        /*!
+         * @brief clamps to the 32 bits a key keeps, NaN goes to the lowest cell
+         */
+        static std::int64_t to_cell(double c) noexcept
+        {
+            constexpr double lo = std::numeric_limits<std::int32_t>::min();
+            constexpr double hi = std::numeric_limits<std::int32_t>::max();
+            c = std::floor(c);
+            return c >= lo ? static_cast<std::int64_t>(std::min(c, hi)) : static_cast<std::int64_t>(lo);
+        }
+
+        /*!
+         * @brief cells of a range, as double because 2^32 x 2^32 clamped cells overflow 64 bits
+         */
+        static double cell_count(std::int64_t x0, std::int64_t y0, std::int64_t x1, std::int64_t y1) noexcept
+        {
+            return static_cast<double>(x1 - x0 + 1) * static_cast<double>(y1 - y0 + 1);
+        }
+
+        static cell_key key(std::int64_t x, std::int64_t y) noexcept
+        {
+            return (static_cast<cell_key>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+        }
+
+        static std::pair<std::int64_t, std::int64_t> cell_at(cell_key k) noexcept
+        {
+            return { static_cast<std::int32_t>(static_cast<std::uint32_t>(k >> 32)), static_cast<std::int32_t>(static_cast<std::uint32_t>(k)) };
+        }
+
+        static void remove(std::vector<const T*>& shapes, const T* shape) noexcept
+        {
+            const auto it = std::find(shapes.begin(), shapes.end(), shape);
+            if (it != shapes.end())
+            {
+                *it = shapes.back();
+                shapes.pop_back();
+            }
+        }
+
+        std::unordered_map<const T*, entry> shapes_;
+        std::array<grid, levels>            grids_;
+        std::vector<const T*>               oversized_;
+    };
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <ostream>
+#include <string_view>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "errors.hpp"
+
+namespace oop
+{
+    namespace detail
+    {
+        /*!
+         * @brief index of the highest set bit, `value` must not be 0
+         */
+        inline size_t highest_bit(std::uint64_t value) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63 - static_cast<size_t>(__builtin_clzll(value));
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long ix;
+            _BitScanReverse64(&ix, value);
+            return ix;
+#else
+            size_t ix = 0;
+            for (size_t shift = 32; shift > 0; shift /= 2)
+            {
+                if (value >> shift)
+                {
+                    value >>= shift;
+                    ix += shift;
+                }
+            }
+            return ix;
+#endif
+        }
+    }
+
+    /*!
+     * @brief log-linear latency histogram in the spirit of HdrHistogram
+     *
+     * Values are bucketed by their highest set bit and `TSubBits` following bits,
+     * which keeps the relative error below 2^-TSubBits with a fixed amount of memory.
+     */
+    template <size_t TSubBits = 4>
+    class basic_histogram
+    {
+        static constexpr size_t sub_buckets = size_t{1} << TSubBits;
+        static constexpr size_t buckets     = (64 - TSubBits + 1) * sub_buckets;
+
+    public:
+        void record(std::uint64_t value) noexcept
+        {
+            ++counts_[index(value)];
+            ++count_;
+            sum_ += value;
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+        }
+
+        /*!
+         * @brief upper bound of the bucket holding the p-th quantile, p in [0, 1]
+         */
+        [[nodiscard]] std::uint64_t percentile(double p) const noexcept
+        {
+            if (count_ == 0)
+            {
+                return 0;
+            }
+
+            const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(count_))));
+            std::uint64_t seen = 0;
+            for (size_t i = 0; i < buckets; ++i)
+            {
+                seen += counts_[i];
+                if (seen >= rank)
+                {
+                    return std::min(upper_bound(i), max_);
+                }
+            }
+            return max_;
+        }
+
+        [[nodiscard]] std::uint64_t count() const noexcept
+        {
+            return count_;
+        }
+
+        [[nodiscard]] std::uint64_t min() const noexcept
+        {
+            return count_ == 0 ? 0 : min_;
+        }
+
+        [[nodiscard]] std::uint64_t max() const noexcept
+        {
+            return max_;
+        }
+
+        [[nodiscard]] double mean() const noexcept
+        {
+            return count_ == 0 ? 0 : static_cast<double>(sum_) / static_cast<double>(count_);
+        }
+
+    private:
+        static size_t index(std::uint64_t value) noexcept
+        {
+            if (value < sub_buckets)
+            {
+                return static_cast<size_t>(value);
+            }
+            const size_t magnitude = detail::highest_bit(value);
+            const size_t shift     = magnitude - TSubBits;
+            return (shift + 1) * sub_buckets + static_cast<size_t>((value >> shift) & (sub_buckets - 1));
+        }
+
+        static std::uint64_t upper_bound(size_t ix) noexcept
+        {
+            if (ix < sub_buckets)
+            {
+                return ix;
+            }
+            const size_t shift = ix / sub_buckets - 1;
+            const std::uint64_t low = (std::uint64_t{sub_buckets} | (ix % sub_buckets)) << shift;
+            return low + ((std::uint64_t{1} << shift) - 1);
+        }
+
+        std::array<std::uint64_t, buckets> counts_{};
+        std::uint64_t                      count_ = 0;
+        std::uint64_t                      sum_   = 0;
+        std::uint64_t                      min_   = UINT64_MAX;
+        std::uint64_t                      max_   = 0;
+    };
+
+    using histogram = basic_histogram<>;
+
+    /*!
+     * @brief per-command latency and error statistics of the command engine
+     *
+     * Commands are addressed by their index in the names table given at construction,
+     * the extra last slot collects everything else.
+     */
+    template <size_t TCommands>
+    class command_stats
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        enum error : size_t
+        {
+            bad_polygon,
+            queue_is_empty,
+            uaf_detected,
+            other_error,
+            errors_count
+        };
+
+        explicit command_stats(const std::array<std::string_view, TCommands>& names) noexcept
+            : names_(names)
+        {}
+
+        /*!
+         * @brief index of the command slot, unknown commands share the last one
+         */
+        [[nodiscard]] size_t command_index(std::string_view name) const noexcept
+        {
+            return static_cast<size_t>(std::find(names_.begin(), names_.end(), name) - names_.begin());
+        }
+
+        void record(size_t command, clock::duration elapsed) noexcept
+        {
+            latency_[command].record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+        /*!
+         * @brief counts an error by the type of the exception, messages are not looked at
+         */
+        void record_error(const std::exception& e) noexcept
+        {
+            if (dynamic_cast<const bad_polygon_error*>(&e))
+            {
+                ++errors_[bad_polygon];
+            }
+            else if (dynamic_cast<const empty_queue_error*>(&e))
+            {
+                ++errors_[queue_is_empty];
+            }
+            else if (dynamic_cast<const use_after_free_error*>(&e))
+            {
+                ++errors_[uaf_detected];
+            }
+            else
+            {
+                ++errors_[other_error];
+            }
+        }
+
+        void record_size(size_t size) noexcept
+        {
+            size_     = size;
+            max_size_ = std::max(max_size_, size);
+        }
+
+        void write(std::ostream& out) const
+        {
+            const auto flags     = out.flags();
+            const auto precision = out.precision();
+
+            out << std::fixed << std::setprecision(3)
+                << "queue size: " << size_ << " (max " << max_size_ << ")\n"
+                << "errors:     bad polygon " << errors_[bad_polygon]
+                << ", queue is empty " << errors_[queue_is_empty]
+                << ", UAF detected " << errors_[uaf_detected]
+                << ", other " << errors_[other_error] << '\n'
+                << std::left << std::setw(10) << "command" << std::right
+                << std::setw(10) << "count"
+                << std::setw(12) << "mean us"
+                << std::setw(12) << "p50 us"
+                << std::setw(12) << "p99 us"
+                << std::setw(12) << "p999 us"
+                << std::setw(12) << "max us" << '\n';
+
+            for (size_t i = 0; i <= TCommands; ++i)
+            {
+                const auto& h = latency_[i];
+                if (h.count() == 0)
+                {
+                    continue;
+                }
+                out << std::left << std::setw(10) << (i < TCommands ? names_[i] : "other") << std::right
+                    << std::setw(10) << h.count()
+                    << std::setw(12) << h.mean() / 1000
+                    << std::setw(12) << static_cast<double>(h.percentile(0.5)) / 1000
+                    << std::setw(12) << static_cast<double>(h.percentile(0.99)) / 1000
+                    << std::setw(12) << static_cast<double>(h.percentile(0.999)) / 1000
+                    << std::setw(12) << static_cast<double>(h.max()) / 1000 << '\n';
+            }
+
+            out.flags(flags);
+            out.precision(precision);
+        }
+
+    private:
+        std::array<std::string_view, TCommands>      names_;
+        std::array<histogram, TCommands + 1>         latency_;
+        std::array<std::uint64_t, errors_count>      errors_{};
+        size_t                                       size_     = 0;
+        size_t                                       max_size_ = 0;
+    };
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace oop
+{
+    /*!
+     * @brief work-stealing thread pool
+     *
+     * Every worker owns a task deque: it pops its own tasks from the back
+     * and steals from the front of the others when it runs dry.
+     * Tasks submitted from a worker go to its own deque, other submissions are spread round-robin.
+     */
+    class thread_pool
+    {
+        struct worker_queue
+        {
+            std::mutex                        mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+    public:
+        /*!
+         * @brief starts `threads` workers, 0 means one per hardware thread
+         */
+        explicit thread_pool(size_t threads = 0)
+        {
+            if (threads == 0)
+            {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            queues_.reserve(threads);
+            for (size_t i = 0; i < threads; ++i)
+            {
+                queues_.push_back(std::make_unique<worker_queue>());
+            }
+            workers_.reserve(threads);
+            for (size_t i = 0; i < threads; ++i)
+            {
+                workers_.emplace_back([this, i] { run(i); });
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        /*!
+         * @brief finishes queued tasks and joins the workers
+         */
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock{ sleep_mutex_ };
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (auto& worker : workers_)
+            {
+                worker.join();
+            }
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return workers_.size();
+        }
+
+        template <typename F>
+        void submit(F&& task)
+        {
+            const size_t ix = current_worker() < size() ? current_worker() : next_++ % size();
+            {
+                std::lock_guard<std::mutex> lock{ queues_[ix]->mutex };
+                queues_[ix]->tasks.emplace_back(std::forward<F>(task));
+                pending_.fetch_add(1, std::memory_order_release);
+            }
+            {
+                std::lock_guard<std::mutex> lock{ sleep_mutex_ };
+            }
+            wake_.notify_one();
+        }
+
+        /*!
+         * @brief runs one queued task on the calling thread
+         * @return false when there was nothing to run
+         */
+        bool run_pending()
+        {
+            std::function<void()> task;
+            if (!take(current_worker(), task))
+            {
+                return false;
+            }
+            task();
+            return true;
+        }
+
+        /*!
+         * @brief calls f(0) ... f(n - 1) on the pool and waits for all of them
+         *
+         * The calling thread helps with queued tasks while waiting,
+         * so it is safe to call from inside a task. The first exception is rethrown.
+         */
+        template <typename F>
+        void parallel_for(size_t n, F&& f)
+        {
+            parallel_for(n, [](size_t i) { return i; }, [&f](size_t i, size_t) { f(i); });
+        }
+
+        /*!
+         * @brief calls f(i, make(i)) for i in [0, n) on the pool and waits for all of them
+         *
+         * make(0) ... make(n - 1) run in order on the calling thread, and every task is submitted
+         * as soon as its argument is made, so producing the arguments overlaps with running the tasks.
+         */
+        template <typename G, typename F>
+        void parallel_for(size_t n, G&& make, F&& f)
+        {
+            std::atomic<size_t> remaining{ n };
+            std::exception_ptr  error;
+            std::mutex          error_mutex;
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                try
+                {
+                    submit([&, i, arg = make(i)]
+                    {
+                        try
+                        {
+                            f(i, arg);
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard<std::mutex> lock{ error_mutex };
+                            if (!error)
+                            {
+                                error = std::current_exception();
+                            }
+                        }
+                        remaining.fetch_sub(1, std::memory_order_acq_rel);
+                    });
+                }
+                catch (...)
+                {
+                    // tasks already submitted still refer to this frame, wait for them
+                    {
+                        std::lock_guard<std::mutex> lock{ error_mutex };
+                        if (!error)
+                        {
+                            error = std::current_exception();
+                        }
+                    }
+                    remaining.fetch_sub(n - i, std::memory_order_acq_rel);
+                    break;
+                }
+            }
+
+            while (remaining.load(std::memory_order_acquire) > 0)
+            {
+                if (!run_pending())
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+    private:
+        static constexpr size_t no_worker = static_cast<size_t>(-1);
+
+        /*!
+         * @brief index of the calling worker in this pool or `no_worker`
+         */
+        size_t current_worker() const noexcept
+        {
+            return worker_pool() == this ? worker_index() : no_worker;
+        }
+
+        static const thread_pool*& worker_pool() noexcept
+        {
+            static thread_local const thread_pool* pool = nullptr;
+            return pool;
+        }
+
+        static size_t& worker_index() noexcept
+        {
+            static thread_local size_t ix = no_worker;
+            return ix;
+        }
+
+        bool take(size_t self, std::function<void()>& task)
+        {
+            if (pending_.load(std::memory_order_acquire) == 0)
+            {
+                return false;
+            }
+
+            // own tasks first, newest first
+            if (self < size())
+            {
+                auto& own = *queues_[self];
+                std::lock_guard<std::mutex> lock{ own.mutex };
+                if (!own.tasks.empty())
+                {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    pending_.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            // steal the oldest task of somebody else
+            const size_t start = self < size() ? self + 1 : 0;
+            for (size_t k = 0; k < size(); ++k)
+            {
+                auto& victim = *queues_[(start + k) % size()];
+                std::lock_guard<std::mutex> lock{ victim.mutex };
+                if (!victim.tasks.empty())
+                {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    pending_.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run(size_t self)
+        {
+            worker_pool()  = this;
+            worker_index() = self;
+
+            std::function<void()> task;
+            while (true)
+            {
+                if (take(self, task))
+                {
+                    task();
+                    task = nullptr;
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock{ sleep_mutex_ };
+                wake_.wait(lock, [this] { return stop_ || pending_.load(std::memory_order_acquire) > 0; });
+                if (stop_ && pending_.load(std::memory_order_acquire) == 0)
+                {
+                    return;
+                }
+            }
+        }
+
+        std::vector<std::unique_ptr<worker_queue>> queues_;
+        std::vector<std::thread>                   workers_;
+        std::atomic<size_t>                        pending_{ 0 };
+        std::atomic<size_t>                        next_{ 0 };
+        std::mutex                                 sleep_mutex_;
+        std::condition_variable                    wake_;
+        bool                                       stop_ = false;
+    };
+}
@@ -0,0 +1,454 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OOP_VALIDATION_SSE2
+#endif
+
+// loop unrolling hint, other compilers warn about the unknown pragma
+#if defined(__GNUC__)
+#define OOP_PRAGMA(text) _Pragma(#text)
+#define OOP_UNROLL(n) OOP_PRAGMA(GCC unroll n)
+#else
+#define OOP_UNROLL(n)
+#endif
+
+#include "point.hpp"
+#include "polygon.hpp"
+
+namespace oop
+{
+    /*!
+     * @brief bits of the per-shape validation status, 0 means valid
+     */
+    namespace shape_status
+    {
+        constexpr std::uint8_t valid          = 0;
+        constexpr std::uint8_t unequal_sides  = 1 << 0;
+        constexpr std::uint8_t unequal_angles = 1 << 1; //!< only checked for 5 and more vertices
+        constexpr std::uint8_t degenerate     = 1 << 2; //!< zero-length side or zero area
+        constexpr std::uint8_t not_convex     = 1 << 3; //!< includes self-intersecting outlines
+    }
+
+    namespace detail
+    {
+        /*!
+         * @brief |a - b| <= eps for lengths given as squares a2 and b2, without sqrt
+         *
+         * (a2 - b2)^2 <= eps^2 (a2 + b2) implies |a - b| <= eps and is implied by |a - b| <= eps / sqrt(2).
+         */
+        inline bool same_length(const double a2, const double b2, const double eps2) noexcept
+        {
+            const double d = a2 - b2;
+            return d * d <= eps2 * (a2 + b2);
+        }
+
+        /*!
+         * @brief branch-free validation of one polygon given by its coordinate arrays
+         *
+         * Loops run over the compile-time vertex count and are fully unrolled, failures are or-ed
+         * instead of branched on. The degenerate area test compares |area2| with tolerance * scale
+         * rather than their squares, which overflow for coordinates beyond 1e77.
+         */
+        template <size_t N>
+        inline std::uint8_t polygon_status(const double (&x)[N], const double (&y)[N], const double tolerance) noexcept
+        {
+            static_assert(N >= 3, "a polygon has at least three vertices");
+            const double eps2 = tolerance * tolerance;
+
+            double side[N];
+            double area2 = 0;
+            double scale = 0;
+            OOP_UNROLL(8)
+            for (size_t k = 0; k < N; ++k)
+            {
+                const size_t next = k + 1 < N ? k + 1 : 0;
+                const double dx = x[next] - x[k];
+                const double dy = y[next] - y[k];
+                side[k] = dx * dx + dy * dy;
+                scale += side[k];
+                if constexpr (N != 4)
+                {
+                    area2 += x[k] * y[next] - x[next] * y[k];
+                }
+            }
+            if constexpr (N == 4)
+            {
+                // the cross product of the diagonals, six products fewer than the shoelace sum
+                area2 = (x[2] - x[0]) * (y[3] - y[1]) - (y[2] - y[0]) * (x[3] - x[1]);
+            }
+
+            bool unequal_sides = false;
+            bool degenerate    = (side[0] == 0) | (std::abs(area2) <= tolerance * scale);
+            OOP_UNROLL(8)
+            for (size_t k = 1; k < N; ++k)
+            {
+                unequal_sides |= !same_length(side[k], side[0], eps2);
+                degenerate    |= side[k] == 0;
+            }
+
+            // a regular polygon also has equal diagonals over one vertex
+            bool unequal_angles = false;
+            if constexpr (N >= 5)
+            {
+                double diagonal[N];
+                OOP_UNROLL(8)
+                for (size_t k = 0; k < N; ++k)
+                {
+                    const size_t skip = k + 2 < N ? k + 2 : k + 2 - N;
+                    const double dx = x[skip] - x[k];
+                    const double dy = y[skip] - y[k];
+                    diagonal[k] = dx * dx + dy * dy;
+                }
+                OOP_UNROLL(8)
+                for (size_t k = 0; k < N; ++k)
+                {
+                    unequal_angles |= !same_length(diagonal[k], diagonal[0], eps2);
+                }
+            }
+
+            bool not_convex = false;
+            if constexpr (N == 4)
+            {
+                // a quadrilateral is convex if each diagonal strictly separates the other two vertices
+                const double c1 = (x[2] - x[0]) * (y[1] - y[0]) - (y[2] - y[0]) * (x[1] - x[0]);
+                const double c3 = (x[2] - x[0]) * (y[3] - y[0]) - (y[2] - y[0]) * (x[3] - x[0]);
+                const double c0 = (x[3] - x[1]) * (y[0] - y[1]) - (y[3] - y[1]) * (x[0] - x[1]);
+                const double c2 = (x[3] - x[1]) * (y[2] - y[1]) - (y[3] - y[1]) * (x[2] - x[1]);
+                not_convex = !(c1 * c3 < 0) | !(c0 * c2 < 0);
+            }
+            else
+            {
+                // every vertex must lie strictly on the inner side of every edge it does not touch,
+                // the sign of the area gives the orientation
+                OOP_UNROLL(8)
+                for (size_t k = 0; k < N; ++k)
+                {
+                    const size_t next = k + 1 < N ? k + 1 : 0;
+                    const double ex = x[next] - x[k];
+                    const double ey = y[next] - y[k];
+                    OOP_UNROLL(8)
+                    for (size_t j = 2; j < N; ++j)
+                    {
+                        const size_t v = k + j < N ? k + j : k + j - N;
+                        const double cross = ex * (y[v] - y[k]) - ey * (x[v] - x[k]);
+                        not_convex |= cross * area2 <= 0;
+                    }
+                }
+            }
+
+            return static_cast<std::uint8_t>(
+                  unequal_sides * shape_status::unequal_sides
+                | unequal_angles * shape_status::unequal_angles
+                | degenerate * shape_status::degenerate
+                | not_convex * shape_status::not_convex);
+        }
+
+#if defined(OOP_VALIDATION_SSE2)
+        /*!
+         * @brief the same checks as polygon_status for pairs of polygons, returns how many were validated
+         *
+         * Every scalar operation maps to one SSE2 instruction on both lanes, so the results are identical
+         * as long as the compiler does not contract the scalar code into fused multiply-adds.
+         * Comparisons that have to fail on NaN use the negated predicates, as `!(a <= b)` does.
+         */
+        template <size_t N>
+        inline size_t polygon_status_x2(const std::array<const double*, N> px, const std::array<const double*, N> py,
+                                        const size_t n, const double tolerance, std::uint8_t* status) noexcept
+        {
+            const __m128d eps2 = _mm_set1_pd(tolerance * tolerance);
+            const __m128d tol  = _mm_set1_pd(tolerance);
+            const __m128d zero = _mm_setzero_pd();
+            const __m128d sign = _mm_set1_pd(-0.0);
+
+            size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+            {
+                __m128d x[N];
+                __m128d y[N];
+                OOP_UNROLL(8)
+                for (size_t k = 0; k < N; ++k)
+                {
+                    x[k] = _mm_loadu_pd(px[k] + i);
+                    y[k] = _mm_loadu_pd(py[k] + i);
+                }
+
+                __m128d side[N];
+                __m128d area2 = zero;
+                __m128d scale = zero;
+                OOP_UNROLL(8)
+                for (size_t k = 0; k < N; ++k)
+                {
+                    const size_t  next = k + 1 < N ? k + 1 : 0;
+                    const __m128d dx   = _mm_sub_pd(x[next], x[k]);
+                    const __m128d dy   = _mm_sub_pd(y[next], y[k]);
+                    side[k] = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+                    scale   = _mm_add_pd(scale, side[k]);
+                    if constexpr (N != 4)
+                    {
+                        area2 = _mm_add_pd(area2, _mm_sub_pd(_mm_mul_pd(x[k], y[next]), _mm_mul_pd(x[next], y[k])));
+                    }
+                }
+                if constexpr (N == 4)
+                {
+                    area2 = _mm_sub_pd(_mm_mul_pd(_mm_sub_pd(x[2], x[0]), _mm_sub_pd(y[3], y[1])),
+                                       _mm_mul_pd(_mm_sub_pd(y[2], y[0]), _mm_sub_pd(x[3], x[1])));
+                }
+
+                const auto not_same_length = [eps2](const __m128d a2, const __m128d b2)
+                {
+                    const __m128d d = _mm_sub_pd(a2, b2);
+                    return _mm_cmpnle_pd(_mm_mul_pd(d, d), _mm_mul_pd(eps2, _mm_add_pd(a2, b2)));
+                };
+
+                __m128d unequal_sides = zero;
+                __m128d degenerate    = _mm_or_pd(_mm_cmpeq_pd(side[0], zero),
+                                                  _mm_cmple_pd(_mm_andnot_pd(sign, area2), _mm_mul_pd(tol, scale)));
+                OOP_UNROLL(8)
+                for (size_t k = 1; k < N; ++k)
+                {
+                    unequal_sides = _mm_or_pd(unequal_sides, not_same_length(side[k], side[0]));
+                    degenerate    = _mm_or_pd(degenerate, _mm_cmpeq_pd(side[k], zero));
+                }
+
+                __m128d unequal_angles = zero;
+                if constexpr (N >= 5)
+                {
+                    __m128d diagonal[N];
+                    OOP_UNROLL(8)
+                    for (size_t k = 0; k < N; ++k)
+                    {
+                        const size_t  skip = k + 2 < N ? k + 2 : k + 2 - N;
+                        const __m128d dx   = _mm_sub_pd(x[skip], x[k]);
+                        const __m128d dy   = _mm_sub_pd(y[skip], y[k]);
+                        diagonal[k] = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+                    }
+                    OOP_UNROLL(8)
+                    for (size_t k = 0; k < N; ++k)
+                    {
+                        unequal_angles = _mm_or_pd(unequal_angles, not_same_length(diagonal[k], diagonal[0]));
+                    }
+                }
+
+                const auto cross = [&x, &y](const size_t o, const size_t a, const size_t b)
+                {
+                    return _mm_sub_pd(_mm_mul_pd(_mm_sub_pd(x[a], x[o]), _mm_sub_pd(y[b], y[o])),
+                                      _mm_mul_pd(_mm_sub_pd(y[a], y[o]), _mm_sub_pd(x[b], x[o])));
+                };
+
+                __m128d not_convex = zero;
+                if constexpr (N == 4)
+                {
+                    const __m128d c13 = _mm_mul_pd(cross(0, 2, 1), cross(0, 2, 3));
+                    const __m128d c02 = _mm_mul_pd(cross(1, 3, 0), cross(1, 3, 2));
+                    not_convex = _mm_or_pd(_mm_cmpnlt_pd(c13, zero), _mm_cmpnlt_pd(c02, zero));
+                }
+                else
+                {
+                    OOP_UNROLL(8)
+                    for (size_t k = 0; k < N; ++k)
+                    {
+                        const size_t next = k + 1 < N ? k + 1 : 0;
+                        OOP_UNROLL(8)
+                        for (size_t j = 2; j < N; ++j)
+                        {
+                            const size_t v = k + j < N ? k + j : k + j - N;
+                            not_convex = _mm_or_pd(not_convex, _mm_cmple_pd(_mm_mul_pd(cross(k, next, v), area2), zero));
+                        }
+                    }
+                }
+
+                // all-ones lanes select their status bit, the low byte of each 64-bit lane is the status
+                const auto bit = [](const __m128d mask, const std::uint8_t value)
+                {
+                    return _mm_and_si128(_mm_castpd_si128(mask), _mm_set1_epi64x(value));
+                };
+                const __m128i lanes = _mm_or_si128(
+                    _mm_or_si128(bit(unequal_sides, shape_status::unequal_sides), bit(unequal_angles, shape_status::unequal_angles)),
+                    _mm_or_si128(bit(degenerate, shape_status::degenerate), bit(not_convex, shape_status::not_convex)));
+                status[i]     = static_cast<std::uint8_t>(_mm_cvtsi128_si32(lanes));
+                status[i + 1] = static_cast<std::uint8_t>(_mm_cvtsi128_si32(_mm_srli_si128(lanes, 8)));
+            }
+            return i;
+        }
+#endif
+    }
+
+    /*!
+     * @brief status of a single polygon: a rhombus for 4 vertices, a regular polygon for more
+     */
+    template <size_t N>
+    std::uint8_t polygon_status(const basic_polygon<point2d, N>& p, const double tolerance) noexcept
+    {
+        double x[N];
+        double y[N];
+        for (size_t k = 0; k < N; ++k)
+        {
+            x[k] = p[k][0];
+            y[k] = p[k][1];
+        }
+        return detail::polygon_status<N>(x, y, tolerance);
+    }
+
+    /*!
+     * @brief true for a non-degenerate rhombus, the check used on input
+     *
+     * Four equal sides put the second and the fourth vertex on the bisector of the first diagonal,
+     * so a quadrilateral with equal sides and non-zero area is a convex rhombus: the same answer as
+     * `polygon_status(r, tolerance) == shape_status::valid` without the convexity test.
+     */
+    inline bool valid_rhombus(const basic_polygon<point2d, 4>& r, const double tolerance) noexcept
+    {
+        const double eps2 = tolerance * tolerance;
+#if defined(OOP_VALIDATION_SSE2)
+        // one register per vertex, x in the low lane and y in the high lane
+        const __m128d p0 = _mm_loadu_pd(r[0].begin());
+        const __m128d p1 = _mm_loadu_pd(r[1].begin());
+        const __m128d p2 = _mm_loadu_pd(r[2].begin());
+        const __m128d p3 = _mm_loadu_pd(r[3].begin());
+
+        const auto square = [](const __m128d from, const __m128d to)
+        {
+            const __m128d d = _mm_sub_pd(to, from);
+            return _mm_mul_pd(d, d);
+        };
+        const __m128d q0 = square(p0, p1);
+        const __m128d q1 = square(p1, p2);
+        const __m128d q2 = square(p2, p3);
+        const __m128d q3 = square(p3, p0);
+
+        // squared sides 0 and 1, 2 and 3, compared with side 0 lane by lane
+        const __m128d s01 = _mm_add_pd(_mm_unpacklo_pd(q0, q1), _mm_unpackhi_pd(q0, q1));
+        const __m128d s23 = _mm_add_pd(_mm_unpacklo_pd(q2, q3), _mm_unpackhi_pd(q2, q3));
+        const __m128d s00 = _mm_unpacklo_pd(s01, s01);
+        const __m128d e2  = _mm_set1_pd(eps2);
+        const auto same_length = [s00, e2](const __m128d a2)
+        {
+            const __m128d d = _mm_sub_pd(a2, s00);
+            return _mm_cmple_pd(_mm_mul_pd(d, d), _mm_mul_pd(e2, _mm_add_pd(a2, s00)));
+        };
+        const bool equal = _mm_movemask_pd(_mm_and_pd(same_length(s01), same_length(s23))) == 3;
+
+        const double side0 = _mm_cvtsd_f64(s01);
+        const double scale = side0 + _mm_cvtsd_f64(_mm_unpackhi_pd(s01, s01))
+                           + _mm_cvtsd_f64(s23) + _mm_cvtsd_f64(_mm_unpackhi_pd(s23, s23));
+
+        const __m128d d13   = _mm_sub_pd(p3, p1);
+        const __m128d cross = _mm_mul_pd(_mm_sub_pd(p2, p0), _mm_shuffle_pd(d13, d13, 1));
+        const double  area2 = _mm_cvtsd_f64(cross) - _mm_cvtsd_f64(_mm_unpackhi_pd(cross, cross));
+
+        return equal & (side0 != 0) & (std::abs(area2) > tolerance * scale);
+#else
+        double side[4];
+        double scale = 0;
+        OOP_UNROLL(4)
+        for (size_t k = 0; k < 4; ++k)
+        {
+            const size_t next = k + 1 < 4 ? k + 1 : 0;
+            const double dx = r[next][0] - r[k][0];
+            const double dy = r[next][1] - r[k][1];
+            side[k] = dx * dx + dy * dy;
+            scale += side[k];
+        }
+        const double area2 = (r[2][0] - r[0][0]) * (r[3][1] - r[1][1]) - (r[2][1] - r[0][1]) * (r[3][0] - r[1][0]);
+
+        return detail::same_length(side[1], side[0], eps2)
+             & detail::same_length(side[2], side[0], eps2)
+             & detail::same_length(side[3], side[0], eps2)
+             & (side[0] != 0)
+             & (std::abs(area2) > tolerance * scale);
+#endif
+    }
+
+    /*!
+     * @brief polygons stored as one array per vertex coordinate for batch validation
+     *
+     * Where SSE2 is available, which includes every x86-64 build, two polygons are validated per step.
+     */
+    template <size_t N>
+    class polygon_batch
+    {
+    public:
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return x_[0].size();
+        }
+
+        void reserve(size_t n)
+        {
+            for (size_t k = 0; k < N; ++k)
+            {
+                x_[k].reserve(n);
+                y_[k].reserve(n);
+            }
+        }
+
+        void push(const basic_polygon<point2d, N>& p)
+        {
+            for (size_t k = 0; k < N; ++k)
+            {
+                x_[k].push_back(p[k][0]);
+                y_[k].push_back(p[k][1]);
+            }
+        }
+
+        void clear() noexcept
+        {
+            for (size_t k = 0; k < N; ++k)
+            {
+                x_[k].clear();
+                y_[k].clear();
+            }
+        }
+
+        /*!
+         * @brief writes the status of every polygon to `status`, which must hold size() entries
+         */
+        void validate(std::uint8_t* status, const double tolerance) const noexcept
+        {
+            std::array<const double*, N> x;
+            std::array<const double*, N> y;
+            for (size_t k = 0; k < N; ++k)
+            {
+                x[k] = x_[k].data();
+                y[k] = y_[k].data();
+            }
+
+            const size_t n = size();
+#if defined(OOP_VALIDATION_SSE2)
+            size_t i = detail::polygon_status_x2<N>(x, y, n, tolerance, status);
+#else
+            size_t i = 0;
+#endif
+            for (; i < n; ++i)
+            {
+                double vx[N];
+                double vy[N];
+                OOP_UNROLL(8)
+                for (size_t k = 0; k < N; ++k)
+                {
+                    vx[k] = x[k][i];
+                    vy[k] = y[k][i];
+                }
+                status[i] = detail::polygon_status<N>(vx, vy, tolerance);
+            }
+        }
+
+        [[nodiscard]] std::vector<std::uint8_t> validate(const double tolerance) const
+        {
+            std::vector<std::uint8_t> status(size());
+            validate(status.data(), tolerance);
+            return status;
+        }
+
+    private:
+        std::array<std::vector<double>, N> x_;
+        std::array<std::vector<double>, N> y_;
+    };
+}
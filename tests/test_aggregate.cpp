@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <vector>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <point.hpp>
+#include <polygon.hpp>
+#include <aggregate.hpp>
+
+using rhombus = basic_polygon<point2d, 4>;
+
+namespace
+{
+    rhombus make_rhombus(double x, double y, double a, double b)
+    {
+        return { point2d{ { x + a, y } }, point2d{ { x, y + b } },
+                 point2d{ { x - a, y } }, point2d{ { x, y - b } } };
+    }
+
+    void expect_matches(const oop::running_aggregate<rhombus>& agg, const std::vector<rhombus>& shapes)
+    {
+        double area = 0, x = 0, y = 0;
+        double lo = INFINITY, hi = 0;
+        for (const auto& r : shapes)
+        {
+            const double a = area2d(r);
+            area += a;
+            x += a * center2d(r)[0];
+            y += a * center2d(r)[1];
+            lo = std::min(lo, a);
+            hi = std::max(hi, a);
+        }
+
+        ASSERT_EQ(agg.count(), shapes.size());
+        ASSERT_NEAR(agg.area(), area, 1e-6 * area);
+        ASSERT_NEAR(agg.centroid()[0], x / area, 1e-6);
+        ASSERT_NEAR(agg.centroid()[1], y / area, 1e-6);
+        ASSERT_DOUBLE_EQ(agg.min_area(), lo);
+        ASSERT_DOUBLE_EQ(agg.max_area(), hi);
+    }
+}
+
+TEST(AGGREGATE, random_mutations) {
+    std::mt19937 gen{ 7 };
+    std::uniform_real_distribution<double> position{ -100, 100 };
+    std::uniform_real_distribution<double> half{ 0.1, 10 };
+    std::bernoulli_distribution push{ 0.6 };
+
+    oop::running_aggregate<rhombus> agg;
+    std::vector<rhombus> shapes;
+    for (int i = 0; i < 5000; ++i)
+    {
+        if (shapes.empty() || push(gen))
+        {
+            const size_t ix = std::uniform_int_distribution<size_t>{ 0, shapes.size() }(gen);
+            shapes.insert(shapes.begin() + ix, make_rhombus(position(gen), position(gen), half(gen), half(gen)));
+            agg.insert(shapes[ix]);
+        }
+        else
+        {
+            const size_t ix = std::uniform_int_distribution<size_t>{ 0, shapes.size() - 1 }(gen);
+            agg.erase(shapes[ix]);
+            shapes.erase(shapes.begin() + ix);
+        }
+        if (!shapes.empty())
+        {
+            expect_matches(agg, shapes);
+        }
+    }
+    ASSERT_EQ(agg.empty(), shapes.empty());
+}
+
+TEST(AGGREGATE, equal_areas) {
+    oop::running_aggregate<rhombus> agg;
+    agg.insert(make_rhombus(0, 0, 1, 1));
+    agg.insert(make_rhombus(5, 5, 1, 1));
+    agg.insert(make_rhombus(-5, 0, 3, 3));
+
+    agg.erase(make_rhombus(0, 0, 1, 1));
+    ASSERT_EQ(agg.count(), 2u);
+    ASSERT_DOUBLE_EQ(agg.min_area(), 2.0);
+    agg.erase(make_rhombus(-5, 0, 3, 3));
+    ASSERT_DOUBLE_EQ(agg.max_area(), 2.0);
+    agg.erase(make_rhombus(5, 5, 1, 1));
+    ASSERT_TRUE(agg.empty());
+}
+
+TEST(AGGREGATE, erase_unknown_shape) {
+    oop::running_aggregate<rhombus> agg;
+    ASSERT_THROW(agg.erase(make_rhombus(0, 0, 1, 1)), std::invalid_argument);
+
+    agg.insert(make_rhombus(0, 0, 1, 1));
+    ASSERT_THROW(agg.erase(make_rhombus(0, 0, 2, 1)), std::invalid_argument);
+    ASSERT_EQ(agg.count(), 1u);
+    ASSERT_DOUBLE_EQ(agg.area(), 2.0);
+}
+
+TEST(AGGREGATE, compensated_sum) {
+    // every naive step loses the small value, the compensation keeps it
+    oop::compensated_sum sum;
+    sum.add(1e16);
+    for (int i = 0; i < 1000; ++i)
+    {
+        sum.add(1.0);
+    }
+    sum.subtract(1e16);
+    ASSERT_DOUBLE_EQ(sum.value(), 1000.0);
+}
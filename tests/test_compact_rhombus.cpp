@@ -0,0 +1,49 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <point.hpp>
+#include <polygon.hpp>
+#include <compact_rhombus.hpp>
+
+namespace
+{
+    constexpr basic_polygon<point2d, 4> tilted{
+        point2d{ { 3, 1 } }, point2d{ { 0.5, 3.5 } }, point2d{ { -1, 0 } }, point2d{ { 1.5, -2.5 } }
+    };
+
+    static_assert(sizeof(compact_rhombus_f) * 2 < sizeof(basic_polygon<point2d, 4>));
+    static_assert(sizeof(compact_rhombus_q) * 2 < sizeof(basic_polygon<point2d, 4>));
+    static_assert(area2d(compact_rhombus{ tilted }) == area2d(tilted));
+    static_assert(get<2>(compact_rhombus{ tilted }) == point2d{ { -1, 0 } });
+}
+
+TEST(COMPACT_RHOMBUS, round_trip) {
+    const compact_rhombus r{ tilted };
+    const auto [a, b, c, d] = r;
+
+    ASSERT_EQ(a, tilted[0]);
+    ASSERT_EQ(b, tilted[1]);
+    ASSERT_EQ(c, tilted[2]);
+    ASSERT_EQ(d, tilted[3]);
+    ASSERT_EQ(r.expand()[3], tilted[3]);
+    ASSERT_EQ(center2d(r), center2d(tilted));
+}
+
+TEST(COMPACT_RHOMBUS, quantized) {
+    const compact_rhombus_f f{ tilted };
+    const compact_rhombus_q q{ tilted };
+
+    ASSERT_NEAR(area2d(f), area2d(tilted), 1e-5);
+    ASSERT_NEAR(area2d(q), area2d(tilted), 1e-2);
+    ASSERT_NEAR(q[1][0], tilted[1][0], 1.0 / 256);
+}
+
+TEST(COMPACT_RHOMBUS, print) {
+    std::ostringstream compact;
+    std::ostringstream full;
+    print2d(compact, compact_rhombus{ tilted });
+    print2d(full, tilted);
+
+    ASSERT_EQ(compact.str(), full.str());
+}
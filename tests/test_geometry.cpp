@@ -0,0 +1,93 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <point.hpp>
+#include <polygon.hpp>
+#include <fixed_point.hpp>
+
+namespace
+{
+    using rhombus  = basic_polygon<point2d, 4>;
+    using pentagon = basic_polygon<point2d, 5>;
+
+    constexpr rhombus unit_rhombus{
+        point2d{ { 0, 0 } }, point2d{ { 1, 1 } }, point2d{ { 2, 0 } }, point2d{ { 1, -1 } }
+    };
+    constexpr pentagon house{
+        point2d{ { 0, 0 } }, point2d{ { 2, 0 } }, point2d{ { 2, 2 } }, point2d{ { 1, 3 } }, point2d{ { 0, 2 } }
+    };
+
+    // geometry folds to constants
+    static_assert(area2d(unit_rhombus) == 2);
+    static_assert(center2d(unit_rhombus) == point2d{ { 1, 0 } });
+    static_assert(area2d(house) == 5);
+    static_assert(unit_rhombus.get<1>() == point2d{ { 1, 1 } });
+    static_assert(std::get<3>(unit_rhombus)[1] == -1);
+    static_assert(point2d{ { 1, 2 } } + point2d{ { 3, 4 } } - point2d{ { 4, 6 } } == point2d{ { 0, 0 } });
+
+    constexpr double tolerance = area2d(unit_rhombus) * 1e-9;
+    static_assert(tolerance > 0);
+}
+
+TEST(GEOMETRY, structured_binding) {
+    const auto [a, b, c, d] = unit_rhombus;
+
+    ASSERT_EQ(a, (point2d{ { 0, 0 } }));
+    ASSERT_EQ(b, (point2d{ { 1, 1 } }));
+    ASSERT_EQ(c, (point2d{ { 2, 0 } }));
+    ASSERT_EQ(d, (point2d{ { 1, -1 } }));
+}
+
+TEST(GEOMETRY, runtime_matches_compile_time) {
+    std::istringstream in{ "0 0 1 1 2 0 1 -1" };
+    const rhombus r{ in };
+
+    ASSERT_DOUBLE_EQ(area2d(r), area2d(unit_rhombus));
+    ASSERT_EQ(center2d(r), center2d(unit_rhombus));
+}
+
+namespace
+{
+    constexpr basic_polygon<point2i, 4> int_rhombus{
+        point2i{ { 0, 0 } }, point2i{ { 1, 1 } }, point2i{ { 2, 0 } }, point2i{ { 1, -1 } }
+    };
+    constexpr basic_polygon<point2i, 3> odd_triangle{
+        point2i{ { 0, 0 } }, point2i{ { 1, 0 } }, point2i{ { 0, 1 } }
+    };
+    constexpr basic_polygon<point2i, 4> huge_square{
+        point2i{ { INT32_MIN, INT32_MIN } }, point2i{ { INT32_MAX, INT32_MIN } },
+        point2i{ { INT32_MAX, INT32_MAX } }, point2i{ { INT32_MIN, INT32_MAX } }
+    };
+    constexpr basic_polygon<point2f, 4> float_rhombus{
+        point2f{ { 0, 0 } }, point2f{ { 1, 1 } }, point2f{ { 2, 0 } }, point2f{ { 1, -1 } }
+    };
+    constexpr basic_polygon<point2q, 4> fixed_rhombus{
+        point2q{ { 0.0, 0.0 } }, point2q{ { 0.5, 0.25 } }, point2q{ { 1.0, 0.0 } }, point2q{ { 0.5, -0.25 } }
+    };
+
+    // integer area is exact and accumulated without overflow
+    static_assert(twice_area2d(int_rhombus) == 4);
+    static_assert(area2d(odd_triangle) == 0.5);
+    static_assert(center2d(odd_triangle)[0] == 1.0 / 3);
+#if defined(__SIZEOF_INT128__)
+    static_assert(twice_area2d(huge_square) == __int128{ 2 } * UINT32_MAX * UINT32_MAX);
+#endif
+
+    // float coordinates, double accumulation
+    static_assert(std::is_same_v<decltype(area2d(float_rhombus)), double>);
+    static_assert(std::is_same_v<decltype(center2d(float_rhombus)), point2f>);
+    static_assert(area2d(float_rhombus) == 2);
+
+    // fixed-point coordinates
+    static_assert(area2d(fixed_rhombus) == 0.25);
+    static_assert(center2d(fixed_rhombus) == point2q{ { 0.5, 0.0 } });
+}
+
+TEST(GEOMETRY, generic_coordinates) {
+    std::istringstream in{ "0 0 0.5 0.25 1 0 0.5 -0.25" };
+    const basic_polygon<point2q, 4> r{ in };
+
+    ASSERT_DOUBLE_EQ(area2d(r), 0.25);
+    ASSERT_EQ(center2d(r), (point2q{ { 0.5, 0.0 } }));
+}
@@ -0,0 +1,195 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <gtest/gtest.h>
+
+#include <journal.hpp>
+#include <repl.hpp>
+
+namespace
+{
+    std::string temp_path(const char* name)
+    {
+        const std::string path = testing::TempDir() + name;
+        std::remove(path.c_str());
+        return path;
+    }
+
+    size_t file_size(const std::string& path)
+    {
+        struct stat st;
+        return ::stat(path.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+    }
+
+    std::string rhombus_at(int x)
+    {
+        std::ostringstream out;
+        out << x << " 0 " << x + 1 << " 1 " << x + 2 << " 0 " << x + 1 << " -1";
+        return out.str();
+    }
+
+    using repl = oop::basic_repl<1 << 14>;
+
+    /*!
+     * @brief runs the commands in a session journaled to `path`
+     */
+    std::unique_ptr<repl> run(const std::string& path, const std::string& commands, std::ostream& out)
+    {
+        static std::stringstream in;
+        in.clear();
+        in.str(commands);
+        auto session = std::make_unique<repl>(in, out);
+        session->open_journal(path);
+
+        std::string input;
+        while (in >> input)
+        {
+            session->execute(input);
+        }
+        return session;
+    }
+}
+
+TEST(JOURNAL, idle_journal_is_synced_within_the_window) {
+    const std::string path = temp_path("journal_idle.bin");
+
+    oop::journal<int> journal{ path, { std::chrono::milliseconds{ 10 }, 1 << 20 } };
+    journal.push(1);
+    journal.push(2);
+
+    // no further appends and no commit: the flusher alone has to write the records
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 5 };
+    while (file_size(path) == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+    ASSERT_GT(file_size(path), 0);
+}
+
+TEST(JOURNAL, commit_and_replay) {
+    const std::string path = temp_path("journal_replay.bin");
+    {
+        oop::journal<int> journal{ path, { std::chrono::seconds{ 60 }, 1 << 20 } };
+        journal.push(1);
+        journal.insert(0, 2);
+        journal.erase(1);
+        journal.pop();
+        journal.commit();
+        ASSERT_GT(file_size(path), 0);
+    }
+    const size_t intact = file_size(path);
+    {
+        // torn tail
+        std::ofstream out{ path, std::ios::binary | std::ios::app };
+        out << "garbage";
+    }
+
+    std::vector<int> ops;
+    oop::journal<int> journal{ path };
+    const size_t count = journal.replay([&ops](oop::journal_op op, size_t ix, const int* v)
+    {
+        ops.push_back(static_cast<int>(op) * 100 + static_cast<int>(ix) * 10 + (v ? *v : 0));
+    });
+    ASSERT_EQ(count, 4);
+    ASSERT_EQ(ops, (std::vector<int>{ 101, 302, 410, 200 }));
+    ASSERT_EQ(file_size(path), intact);
+}
+
+TEST(JOURNAL, compact_replaces_history) {
+    const std::string path = temp_path("journal_compact.bin");
+    {
+        oop::journal<int> journal{ path };
+        for (int i = 0; i < 100; ++i)
+        {
+            journal.push(i);
+        }
+        for (int i = 0; i < 90; ++i)
+        {
+            journal.pop();
+        }
+        ASSERT_EQ(journal.records(), 190);
+
+        journal.compact([](auto&& emit)
+        {
+            for (int i = 90; i < 100; ++i)
+            {
+                emit(oop::journal_op::push, 0, &i);
+            }
+        });
+        ASSERT_EQ(journal.records(), 10);
+        journal.pop();
+    }
+
+    std::vector<int> ops;
+    oop::journal<int> journal{ path };
+    const size_t count = journal.replay([&ops](oop::journal_op op, size_t, const int* v)
+    {
+        ops.push_back(static_cast<int>(op) * 100 + (v ? *v : 0));
+    });
+    ASSERT_EQ(count, 11);
+    ASSERT_EQ(ops.front(), 190);
+    ASSERT_EQ(ops.back(), 200);
+}
+
+TEST(JOURNAL, rejected_commands_are_not_journaled) {
+    const std::string path = temp_path("journal_rejected.bin");
+    std::ostringstream out;
+    run(path, "push " + rhombus_at(0) + "\npush " + rhombus_at(3)
+        + "\nerase x\nerase 7\ninsert 9 " + rhombus_at(6) + "\nless x\npq_pop\n", out);
+    ASSERT_EQ(out.str().find("dropped"), std::string::npos);
+
+    oop::journal<rhombus> journal{ path };
+    ASSERT_EQ(journal.replay([](oop::journal_op op, size_t, const rhombus*) { ASSERT_EQ(op, oop::journal_op::push); }), 2);
+}
+
+TEST(JOURNAL, repl_compacts_and_recovers) {
+    const std::string path = temp_path("journal_session.bin");
+    std::string commands;
+    for (int i = 0; i < 10; ++i)
+    {
+        commands += "push " + rhombus_at(i) + "\npq_push " + rhombus_at(i) + "\n";
+    }
+    for (int i = 0; i < 5000; ++i)
+    {
+        commands += "pop\npush " + rhombus_at(i % 10) + "\n";
+    }
+    commands += "drop_less 0\n";
+
+    std::ostringstream out;
+    std::vector<rhombus> queue;
+    std::vector<rhombus> heap;
+    {
+        auto session = run(path, commands, out);
+        for (const rhombus& r : session->get_queue())
+        {
+            queue.push_back(r);
+        }
+        session->get_priority_queue().for_each([&heap](const rhombus& r) { heap.push_back(r); });
+    }
+    // the journal holds a snapshot and the commands since, not all 10021 records
+    ASSERT_LT(file_size(path), 4200 * 100);
+
+    auto session = run(path, "", out);
+    std::vector<rhombus> restored;
+    for (const rhombus& r : session->get_queue())
+    {
+        restored.push_back(r);
+    }
+    ASSERT_EQ(restored.size(), queue.size());
+    ASSERT_TRUE(std::equal(queue.begin(), queue.end(), restored.begin(),
+        [](const rhombus& a, const rhombus& b) { return std::equal(a.begin(), a.end(), b.begin()); }));
+
+    std::vector<rhombus> restored_heap;
+    session->get_priority_queue().for_each([&restored_heap](const rhombus& r) { restored_heap.push_back(r); });
+    ASSERT_EQ(restored_heap.size(), heap.size());
+    ASSERT_TRUE(std::equal(heap.begin(), heap.end(), restored_heap.begin(),
+        [](const rhombus& a, const rhombus& b) { return std::equal(a.begin(), a.end(), b.begin()); }));
+}
@@ -0,0 +1,154 @@
+#include <atomic>
+#include <deque>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <allocator.hpp>
+#include <persistent_queue.hpp>
+
+namespace
+{
+    template <typename S>
+    std::vector<int> contents(const S& snapshot)
+    {
+        return { snapshot.begin(), snapshot.end() };
+    }
+}
+
+TEST(PERSISTENT_QUEUE, snapshots_are_isolated) {
+    oop::persistent_queue<int> q;
+    std::deque<int> model;
+
+    std::vector<std::pair<decltype(q.get_snapshot()), std::vector<int>>> versions;
+
+    std::mt19937 gen{ 3 };
+    std::uniform_int_distribution<int> op{ 0, 3 };
+    for (int i = 0; i < 2000; ++i)
+    {
+        const size_t size = model.size();
+        switch (size == 0 ? 0 : op(gen))
+        {
+        case 0:
+            q.push(i);
+            model.push_back(i);
+            break;
+        case 1:
+            q.pop();
+            model.pop_front();
+            break;
+        case 2:
+        {
+            const size_t ix = std::uniform_int_distribution<size_t>{ 0, size }(gen);
+            q.insert(ix, i);
+            model.insert(model.begin() + ix, i);
+            break;
+        }
+        case 3:
+        {
+            const size_t ix = std::uniform_int_distribution<size_t>{ 0, size - 1 }(gen);
+            q.erase(ix);
+            model.erase(model.begin() + ix);
+            break;
+        }
+        }
+
+        if (i % 50 == 0)
+        {
+            versions.emplace_back(q.get_snapshot(), std::vector<int>(model.begin(), model.end()));
+        }
+    }
+
+    ASSERT_EQ(contents(q.get_snapshot()), std::vector<int>(model.begin(), model.end()));
+    for (const auto& [snapshot, expected] : versions)
+    {
+        ASSERT_EQ(snapshot.size(), expected.size());
+        ASSERT_EQ(contents(snapshot), expected);
+    }
+}
+
+TEST(PERSISTENT_QUEUE, long_chains_are_released_iteratively) {
+    auto q = std::make_unique<oop::persistent_queue<int>>();
+    for (int i = 0; i < 1000000; ++i)
+    {
+        q->push(i);
+    }
+    auto snapshot = q->get_snapshot();
+    for (int i = 0; i < 999999; ++i)
+    {
+        q->pop();
+    }
+    ASSERT_EQ(q->top(), 999999);
+    ASSERT_EQ(snapshot.size(), 1000000);
+
+    snapshot = {};
+    q.reset();
+}
+
+TEST(PERSISTENT_QUEUE, concurrent_readers) {
+    oop::persistent_queue<int> q;
+    std::atomic<bool> done{ false };
+
+    std::thread writer([&]
+    {
+        for (int i = 0; i < 100000; ++i)
+        {
+            q.push(i);
+            if (i % 3 == 0)
+            {
+                q.pop();
+            }
+        }
+        done = true;
+    });
+
+    // every snapshot must be a contiguous ascending run
+    size_t checked = 0;
+    while (!done)
+    {
+        const auto snapshot = q.get_snapshot();
+        size_t count = 0;
+        int previous = -1;
+        for (int v : snapshot)
+        {
+            ASSERT_TRUE(previous < 0 || v == previous + 1);
+            previous = v;
+            ++count;
+        }
+        ASSERT_EQ(count, snapshot.size());
+        ++checked;
+    }
+    writer.join();
+    ASSERT_GT(checked, 0);
+}
+
+TEST(PERSISTENT_QUEUE, nodes_come_from_the_allocator) {
+    constexpr size_t pool_size = 8;
+    using queue = oop::persistent_queue<int, oop::vector_allocator<int, pool_size>>;
+
+    queue::snapshot snapshot;
+    {
+        queue q;
+        for (int i = 0; i < 6; ++i)
+        {
+            q.push(i);
+        }
+        snapshot = q.get_snapshot();
+
+        // the copied prefix does not fit next to the shared nodes
+        ASSERT_THROW(q.erase(5), std::bad_alloc);
+        ASSERT_EQ(contents(q.get_snapshot()), (std::vector<int>{ 0, 1, 2, 3, 4, 5 }));
+
+        q.erase(1);
+        ASSERT_EQ(contents(q.get_snapshot()), (std::vector<int>{ 0, 2, 3, 4, 5 }));
+        // six shared nodes and one copy, the failed erase gave its copies back
+        q.push(6);
+        ASSERT_THROW(q.push(7), std::bad_alloc);
+    }
+    // the pool outlives the queue as long as a snapshot refers to it
+    ASSERT_EQ(contents(snapshot), (std::vector<int>{ 0, 1, 2, 3, 4, 5 }));
+    snapshot = {};
+}
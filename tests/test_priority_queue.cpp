@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <point.hpp>
+#include <polygon.hpp>
+#include <allocator.hpp>
+#include <priority_queue.hpp>
+
+namespace
+{
+    struct identity
+    {
+        int operator()(int v) const noexcept
+        {
+            return v;
+        }
+    };
+
+    using int_heap = oop::priority_queue<int, identity, std::less<>, 4, oop::vector_allocator<int, 1 << 12>>;
+}
+
+TEST(PRIORITY_QUEUE, order) {
+    std::mt19937 gen{ 1 };
+    std::uniform_int_distribution<int> value{ -1000, 1000 };
+
+    int_heap heap;
+    std::vector<int> expected;
+    for (int i = 0; i < 4000; ++i)
+    {
+        const int v = value(gen);
+        heap.push(v);
+        expected.push_back(v);
+    }
+    std::sort(expected.begin(), expected.end(), std::greater<>{});
+
+    for (int v : expected)
+    {
+        ASSERT_EQ(heap.top(), v);
+        heap.pop();
+    }
+    ASSERT_TRUE(heap.empty());
+    ASSERT_THROW(heap.pop(), std::out_of_range);
+}
+
+TEST(PRIORITY_QUEUE, update_and_erase) {
+    oop::priority_queue<int, identity, std::greater<>, 3> heap;
+
+    std::vector<oop::priority_queue<int, identity, std::greater<>, 3>::handle> handles;
+    for (int i = 0; i < 100; ++i)
+    {
+        handles.push_back(heap.push(i * 10));
+    }
+    ASSERT_EQ(heap.top(), 0);
+
+    // decrease-key moves an element to the top, increase-key moves it down
+    heap.update(handles[50], -5);
+    ASSERT_EQ(heap.top(), -5);
+    heap.update(handles[50], 10000);
+    ASSERT_EQ(heap.top(), 0);
+    ASSERT_EQ(heap.value(handles[50]), 10000);
+
+    heap.erase(handles[0]);
+    heap.erase(handles[99]);
+    ASSERT_EQ(heap.size(), 98);
+
+    std::vector<int> popped;
+    while (!heap.empty())
+    {
+        popped.push_back(heap.top());
+        heap.pop();
+    }
+    ASSERT_TRUE(std::is_sorted(popped.begin(), popped.end()));
+    ASSERT_EQ(popped.front(), 10);
+    ASSERT_EQ(popped.back(), 10000);
+}
+
+TEST(PRIORITY_QUEUE, area_projection) {
+    using rhombus = basic_polygon<point2d, 4>;
+    const auto make = [](double a)
+    {
+        return rhombus{ point2d{ { a, 0 } }, point2d{ { 0, a } }, point2d{ { -a, 0 } }, point2d{ { 0, -a } } };
+    };
+
+    oop::priority_queue<rhombus> heap;
+    heap.push(make(1));
+    heap.push(make(3));
+    heap.push(make(2));
+
+    ASSERT_DOUBLE_EQ(heap.top_key(), 18);
+    heap.pop();
+    ASSERT_DOUBLE_EQ(area2d(heap.top()), 8);
+}
@@ -0,0 +1,168 @@
+#include <new>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <allocator.hpp>
+#include <queue.hpp>
+
+auto constexpr pool_size = 1 << 16;
+
+namespace
+{
+    template <typename Q>
+    std::vector<int> contents(Q& q)
+    {
+        std::vector<int> result;
+        for (int v : q)
+        {
+            result.push_back(v);
+        }
+        return result;
+    }
+}
+
+TEST(QUEUE, insert_erase_keep_size_and_tail) {
+    oop::queue<int, oop::vector_allocator<int, pool_size>> q;
+    q.insert(q.begin(), 1);
+    q.insert(q.end(), 3);
+    q.insert(++q.begin(), 2);
+    ASSERT_EQ(q.size(), 3);
+
+    // push goes after the node appended by insert
+    q.push(4);
+    ASSERT_EQ(contents(q), (std::vector<int>{ 1, 2, 3, 4 }));
+
+    // erasing the tail moves last_ to its predecessor
+    auto it = q.begin();
+    std::advance(it, 3);
+    q.erase(it);
+    q.push(5);
+    ASSERT_EQ(contents(q), (std::vector<int>{ 1, 2, 3, 5 }));
+    ASSERT_EQ(q.size(), 4);
+
+    while (q.size() > 1)
+    {
+        q.erase(++q.begin());
+    }
+    q.erase(q.begin());
+    ASSERT_EQ(q.size(), 0);
+    q.push(6);
+    ASSERT_EQ(contents(q), (std::vector<int>{ 6 }));
+}
+
+TEST(QUEUE, insert_into_full_pool) {
+    oop::queue<int, oop::vector_allocator<int, 2>> q;
+    q.push(1);
+    q.push(2);
+
+    // the failed allocation must not cut the queue after the insert position
+    ASSERT_THROW(q.insert(q.begin(), 0), std::bad_alloc);
+    ASSERT_EQ(q.size(), 2);
+    ASSERT_EQ(contents(q), (std::vector<int>{ 1, 2 }));
+
+    q.pop();
+    q.insert(q.end(), 3);
+    ASSERT_EQ(contents(q), (std::vector<int>{ 2, 3 }));
+}
+
+TEST(QUEUE, pop_to_empty) {
+    oop::queue<int, oop::vector_allocator<int, pool_size>> q;
+    q.push(1);
+    q.pop();
+    ASSERT_EQ(q.size(), 0);
+
+    q.push(2);
+    q.push(3);
+    ASSERT_EQ(contents(q), (std::vector<int>{ 2, 3 }));
+}
+
+TEST(QUEUE, long_queue_destruction) {
+    oop::queue<int> q;
+    for (int i = 0; i < 1000000; ++i)
+    {
+        q.push(i);
+    }
+}
+
+TEST(QUEUE, erase_if) {
+    oop::queue<int, oop::vector_allocator<int, pool_size>> q;
+    for (int i = 0; i < 10; ++i)
+    {
+        q.push(i);
+    }
+
+    ASSERT_EQ(q.erase_if([](int v) { return v % 3 != 1; }), 7);
+    ASSERT_EQ(contents(q), (std::vector<int>{ 1, 4, 7 }));
+    ASSERT_EQ(q.size(), 3);
+
+    // the tail has to stay valid for push
+    q.push(10);
+    ASSERT_EQ(contents(q), (std::vector<int>{ 1, 4, 7, 10 }));
+
+    ASSERT_EQ(q.retain_if([](int v) { return v > 5; }), 2);
+    q.push(11);
+    ASSERT_EQ(contents(q), (std::vector<int>{ 7, 10, 11 }));
+
+    ASSERT_EQ(q.erase_if([](int) { return true; }), 3);
+    ASSERT_EQ(q.size(), 0);
+    q.push(12);
+    ASSERT_EQ(q.top(), 12);
+}
+
+TEST(QUEUE, erase_if_reuses_nodes) {
+    oop::queue<int, oop::vector_allocator<int, pool_size>> q;
+    for (int i = 0; i < pool_size; ++i)
+    {
+        q.push(i);
+    }
+
+    // purge 90% in one pass, then refill the pool completely
+    q.erase_if([](int v) { return v % 10 != 0; });
+    ASSERT_EQ(q.size(), pool_size / 10 + 1);
+    while (q.size() < pool_size)
+    {
+        q.push(-1);
+    }
+    ASSERT_THROW(q.push(-1), std::bad_alloc);
+}
+
+TEST(QUEUE, erase_if_throwing_predicate) {
+    oop::queue<int> q;
+    for (int i = 0; i < 6; ++i)
+    {
+        q.push(i);
+    }
+
+    ASSERT_THROW(q.erase_if([](int v)
+    {
+        if (v == 4)
+        {
+            throw std::runtime_error{"stop"};
+        }
+        return v % 2 == 0;
+    }), std::runtime_error);
+
+    ASSERT_EQ(contents(q), (std::vector<int>{ 1, 3, 4, 5 }));
+    ASSERT_EQ(q.size(), 4);
+    q.push(6);
+    ASSERT_EQ(contents(q), (std::vector<int>{ 1, 3, 4, 5, 6 }));
+}
+
+TEST(QUEUE, erase_if_reports_removed) {
+    oop::queue<int> q;
+    for (int i = 0; i < 6; ++i)
+    {
+        q.push(i);
+    }
+
+    std::vector<int> removed;
+    ASSERT_EQ(q.erase_if([](int v) { return v % 2 == 0; }, [&removed, &q](int v)
+    {
+        // runs once the pass is over
+        ASSERT_EQ(q.size(), 3);
+        removed.push_back(v);
+    }), 3);
+    ASSERT_EQ(removed, (std::vector<int>{ 0, 2, 4 }));
+    ASSERT_EQ(contents(q), (std::vector<int>{ 1, 3, 5 }));
+}
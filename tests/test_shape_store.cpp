@@ -0,0 +1,56 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <point.hpp>
+#include <polygon.hpp>
+#include <shape_store.hpp>
+
+using store = oop::shape_store<point2d, 4, 5, 6>;
+
+namespace
+{
+    template <size_t N>
+    basic_polygon<point2d, N> regular(double scale)
+    {
+        basic_polygon<point2d, N> p;
+        for (size_t i = 0; i < N; ++i)
+        {
+            const double phi = 2 * M_PI * static_cast<double>(i) / N;
+            p[i] = point2d{ { scale * std::cos(phi), scale * std::sin(phi) } };
+        }
+        return p;
+    }
+}
+
+TEST(SHAPE_STORE, insertion_order) {
+    store s;
+    s.push(regular<4>(1));
+    s.push(regular<6>(1));
+    s.push(regular<5>(1));
+    s.insert(1, regular<5>(2));
+
+    std::vector<size_t> arities;
+    s.for_each([&arities](const auto& p) { arities.push_back(p.size()); });
+
+    ASSERT_EQ(arities, (std::vector<size_t>{ 4, 5, 6, 5 }));
+    ASSERT_EQ(s.count<5>(), 2);
+    ASSERT_DOUBLE_EQ(s.area(0), area2d(regular<4>(1)));
+    ASSERT_DOUBLE_EQ(s.area(1), area2d(regular<5>(2)));
+    ASSERT_NEAR(s.center(2)[0], 0, 1e-12);
+}
+
+TEST(SHAPE_STORE, slot_reuse) {
+    store s;
+    s.push(regular<4>(1));
+    s.push(regular<4>(2));
+    s.pop();
+    s.erase(0);
+    ASSERT_TRUE(s.empty());
+    ASSERT_THROW(s.pop(), std::out_of_range);
+
+    s.push(regular<4>(3));
+    ASSERT_EQ(s.count<4>(), 1);
+    ASSERT_DOUBLE_EQ(s.area(0), area2d(regular<4>(3)));
+    ASSERT_EQ(s.visit(0, [](const auto& p) { return p.size(); }), 4);
+}
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <point.hpp>
+#include <polygon.hpp>
+#include <spatial_index.hpp>
+
+using rhombus = basic_polygon<point2d, 4>;
+using grid    = oop::spatial_index<rhombus>;
+
+namespace
+{
+    rhombus make_rhombus(double x, double y, double a, double b)
+    {
+        return { point2d{ { x + a, y } }, point2d{ { x, y + b } },
+                 point2d{ { x - a, y } }, point2d{ { x, y - b } } };
+    }
+
+    std::deque<rhombus> random_rhombi(size_t n, unsigned seed)
+    {
+        std::mt19937 gen{ seed };
+        std::uniform_real_distribution<double> position{ -500, 500 };
+        std::uniform_real_distribution<double> half{ 0.5, 20 };
+
+        std::deque<rhombus> result;
+        for (size_t i = 0; i < n; ++i)
+        {
+            result.push_back(make_rhombus(position(gen), position(gen), half(gen), half(gen)));
+        }
+        // a few shapes larger than the oversize limit
+        result.push_back(make_rhombus(0, 0, 800, 300));
+        result.push_back(make_rhombus(100, -50, 600, 600));
+        return result;
+    }
+
+    template <typename F>
+    std::vector<const rhombus*> collect(F&& query)
+    {
+        std::vector<const rhombus*> result;
+        query([&result](const rhombus* r) { result.push_back(r); });
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+TEST(SPATIAL_INDEX, contains) {
+    const auto shapes = random_rhombi(2000, 1);
+    grid ix{ 16 };
+    for (const auto& r : shapes)
+    {
+        ix.insert(&r);
+    }
+
+    std::mt19937 gen{ 2 };
+    std::uniform_real_distribution<double> position{ -600, 600 };
+    for (int q = 0; q < 200; ++q)
+    {
+        const point2d p{ { position(gen), position(gen) } };
+        std::vector<const rhombus*> expected;
+        for (const auto& r : shapes)
+        {
+            if (oop::detail::inside(oop::detail::vertices(r), p))
+            {
+                expected.push_back(&r);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+
+        ASSERT_EQ(collect([&](auto out) { ix.contains(p, out); }), expected);
+    }
+}
+
+TEST(SPATIAL_INDEX, intersects) {
+    const auto shapes = random_rhombi(2000, 3);
+    grid ix{ 16 };
+    for (const auto& r : shapes)
+    {
+        ix.insert(&r);
+    }
+
+    std::mt19937 gen{ 4 };
+    std::uniform_real_distribution<double> position{ -600, 600 };
+    std::uniform_real_distribution<double> extent{ 0, 100 };
+    for (int q = 0; q < 200; ++q)
+    {
+        const point2d lo{ { position(gen), position(gen) } };
+        const oop::box2d box{ lo, point2d{ { lo[0] + extent(gen), lo[1] + extent(gen) } } };
+
+        std::vector<const rhombus*> expected;
+        for (const auto& r : shapes)
+        {
+            if (oop::detail::intersects(oop::detail::vertices(r), box))
+            {
+                expected.push_back(&r);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+
+        ASSERT_EQ(collect([&](auto out) { ix.intersects(box, out); }), expected);
+    }
+}
+
+TEST(SPATIAL_INDEX, nearest) {
+    const auto shapes = random_rhombi(2000, 5);
+    grid ix{ 16 };
+    for (const auto& r : shapes)
+    {
+        ix.insert(&r);
+    }
+    // drop the oversized shapes again so the search has to walk rings
+    ix.erase(&shapes[shapes.size() - 1]);
+    ix.erase(&shapes[shapes.size() - 2]);
+    ASSERT_EQ(ix.size(), 2000);
+
+    std::mt19937 gen{ 6 };
+    std::uniform_real_distribution<double> position{ -900, 900 };
+    for (int q = 0; q < 100; ++q)
+    {
+        const point2d p{ { position(gen), position(gen) } };
+        std::vector<double> expected;
+        for (size_t i = 0; i < 2000; ++i)
+        {
+            expected.push_back(oop::detail::distance(oop::detail::vertices(shapes[i]), p));
+        }
+        std::sort(expected.begin(), expected.end());
+
+        const auto found = ix.nearest(p, 5);
+        ASSERT_EQ(found.size(), 5);
+        for (size_t i = 0; i < found.size(); ++i)
+        {
+            ASSERT_DOUBLE_EQ(found[i].first, expected[i]);
+        }
+    }
+}
+
+TEST(SPATIAL_INDEX, erase) {
+    const rhombus a = make_rhombus(0, 0, 10, 10);
+    const rhombus b = make_rhombus(5, 5, 10, 10);
+
+    grid ix;
+    ix.insert(&a);
+    ix.insert(&b);
+    ASSERT_EQ(collect([&](auto out) { ix.contains(point2d{ { 4, 4 } }, out); }).size(), 2);
+
+    ix.erase(&a);
+    ASSERT_EQ(collect([&](auto out) { ix.contains(point2d{ { 4, 4 } }, out); }),
+              (std::vector<const rhombus*>{ &b }));
+    ASSERT_TRUE(ix.nearest(point2d{ { -100, -100 } }, 3).size() == 1);
+    ASSERT_THROW(ix.insert(&b), std::invalid_argument);
+}
+
+TEST(SPATIAL_INDEX, far_query) {
+    const rhombus a = make_rhombus(0, 0, 1, 1);
+    grid ix;
+    ix.insert(&a);
+
+    // the search starts at the occupied extent instead of walking every ring up to it
+    for (const double far : { 2e4, 2e5, 1e9, 1e12, 1e300 })
+    {
+        const auto found = ix.nearest(point2d{ { far, far } }, 1);
+        ASSERT_EQ(found.size(), 1);
+        ASSERT_EQ(found[0].second, &a);
+        ASSERT_DOUBLE_EQ(found[0].first, oop::detail::distance(oop::detail::vertices(a), point2d{ { far, far } }));
+    }
+
+    // shapes far apart: the extent is huge but almost empty
+    const rhombus b = make_rhombus(3e6, -2e6, 1, 1);
+    const rhombus c = make_rhombus(1e11, 1e11, 1, 1);
+    ix.insert(&b);
+    ix.insert(&c);
+    for (const point2d& p : { point2d{ { 1e6, 0 } }, point2d{ { 2e6, -2e6 } }, point2d{ { 1e11, 0 } }, point2d{ { -1e15, 5 } } })
+    {
+        std::vector<double> expected;
+        for (const rhombus* r : { &a, &b, &c })
+        {
+            expected.push_back(oop::detail::distance(oop::detail::vertices(*r), p));
+        }
+        std::sort(expected.begin(), expected.end());
+
+        const auto found = ix.nearest(p, 3);
+        ASSERT_EQ(found.size(), 3);
+        for (size_t i = 0; i < found.size(); ++i)
+        {
+            ASSERT_DOUBLE_EQ(found[i].first, expected[i]);
+        }
+    }
+
+    // coordinates beyond the 32-bit cell range are clamped, not cast
+    ASSERT_TRUE(collect([&](auto out) { ix.contains(point2d{ { 1e300, -1e300 } }, out); }).empty());
+    const oop::box2d everything{ point2d{ { -1e300, -1e300 } }, point2d{ { 1e300, 1e300 } } };
+    ASSERT_EQ(collect([&](auto out) { ix.intersects(everything, out); }).size(), 3);
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const rhombus bad = make_rhombus(nan, 0, 1, 1);
+    ASSERT_THROW(ix.insert(&bad), std::invalid_argument);
+}
+
+TEST(SPATIAL_INDEX, levels) {
+    // sizes across every level and beyond the coarsest one
+    std::mt19937 gen{ 7 };
+    std::uniform_real_distribution<double> position{ -5000, 5000 };
+    std::uniform_real_distribution<double> scale{ 0, 6 };
+    std::deque<rhombus> shapes;
+    for (int i = 0; i < 3000; ++i)
+    {
+        shapes.push_back(make_rhombus(position(gen), position(gen), std::pow(10.0, scale(gen)), std::pow(10.0, scale(gen))));
+    }
+
+    grid ix{ 16 };
+    for (const auto& r : shapes)
+    {
+        ix.insert(&r);
+    }
+    // erase every other shape, the extents have to follow
+    for (size_t i = 0; i < shapes.size(); i += 2)
+    {
+        ix.erase(&shapes[i]);
+    }
+
+    std::uniform_real_distribution<double> query{ -20000, 20000 };
+    for (int q = 0; q < 100; ++q)
+    {
+        const point2d p{ { query(gen), query(gen) } };
+        const oop::box2d box{ p, point2d{ { p[0] + 300, p[1] + 300 } } };
+
+        std::vector<const rhombus*> inside, crossing;
+        std::vector<double> distances;
+        for (size_t i = 1; i < shapes.size(); i += 2)
+        {
+            const auto v = oop::detail::vertices(shapes[i]);
+            if (oop::detail::inside(v, p))
+            {
+                inside.push_back(&shapes[i]);
+            }
+            if (oop::detail::intersects(v, box))
+            {
+                crossing.push_back(&shapes[i]);
+            }
+            distances.push_back(oop::detail::distance(v, p));
+        }
+        std::sort(inside.begin(), inside.end());
+        std::sort(crossing.begin(), crossing.end());
+        std::sort(distances.begin(), distances.end());
+
+        ASSERT_EQ(collect([&](auto out) { ix.contains(p, out); }), inside);
+        ASSERT_EQ(collect([&](auto out) { ix.intersects(box, out); }), crossing);
+
+        const auto found = ix.nearest(p, 5);
+        ASSERT_EQ(found.size(), 5);
+        for (size_t i = 0; i < found.size(); ++i)
+        {
+            ASSERT_DOUBLE_EQ(found[i].first, distances[i]);
+        }
+    }
+}
+
+TEST(SPATIAL_INDEX, extent_shrinks_on_erase) {
+    const rhombus a = make_rhombus(0, 0, 1, 1);
+    const rhombus b = make_rhombus(1e6, 0, 1, 1);
+    const rhombus c = make_rhombus(10, 0, 1, 1);
+
+    grid ix;
+    ix.insert(&a);
+    ix.insert(&b);
+    ASSERT_EQ(ix.nearest(point2d{ { 2e6, 0 } }, 1)[0].second, &b);
+
+    ix.erase(&b);
+    ix.insert(&c);
+    for (const point2d& p : { point2d{ { 2e6, 0 } }, point2d{ { 5e5, 0 } }, point2d{ { -3, 0 } } })
+    {
+        const auto found = ix.nearest(p, 2);
+        ASSERT_EQ(found.size(), 2);
+        ASSERT_EQ(found[0].second, p[0] > 5 ? &c : &a);
+    }
+}
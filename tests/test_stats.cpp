@@ -0,0 +1,33 @@
+#include <array>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include <errors.hpp>
+#include <stats.hpp>
+
+TEST(STATS, highest_bit) {
+    for (size_t bit = 0; bit < 64; ++bit)
+    {
+        const std::uint64_t value = std::uint64_t{1} << bit;
+        ASSERT_EQ(oop::detail::highest_bit(value), bit);
+        ASSERT_EQ(oop::detail::highest_bit(value | (value - 1)), bit);
+    }
+}
+
+TEST(STATS, errors_are_classified_by_type) {
+    oop::command_stats<1> stats{ std::array<std::string_view, 1>{ "push" } };
+    stats.record_error(oop::bad_polygon_error{});
+    stats.record_error(oop::empty_queue_error{});
+    stats.record_error(oop::empty_queue_error{});
+    stats.record_error(oop::use_after_free_error{});
+    // same message, different type
+    stats.record_error(std::invalid_argument{ "bad polygon" });
+
+    std::ostringstream out;
+    stats.write(out);
+    ASSERT_NE(out.str().find("bad polygon 1, queue is empty 2, UAF detected 1, other 1"), std::string::npos);
+}
@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 
 #include <allocator.hpp>
+#include <errors.hpp>
 
 auto constexpr pool_size = 0x100;
 
@@ -37,3 +38,26 @@ TEST(STLCONTAINERS, list) {
         ASSERT_EQ(*it, i);
     }
 }
+
+TEST(STLCONTAINERS, double_free) {
+    oop::vector_allocator<int, pool_size> al;
+    int* a = al.allocate(1);
+    int* b = al.allocate(1);
+    int* c = al.allocate(1);
+
+    al.deallocate(a, 1);
+    ASSERT_THROW(al.deallocate(a, 1), oop::use_after_free_error);
+
+    // a repeated or already free block rejects the whole batch
+    int* twice[] = { b, c, b };
+    ASSERT_THROW(al.deallocate_batch(twice, 3), oop::use_after_free_error);
+    int* stale[] = { b, a };
+    ASSERT_THROW(al.deallocate_batch(stale, 2), oop::use_after_free_error);
+
+    int* rest[] = { b, c };
+    al.deallocate_batch(rest, 2);
+
+    // blocks handed out again can be freed again
+    int* d = al.allocate(1);
+    al.deallocate(d, 1);
+}
@@ -0,0 +1,109 @@
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <repl.hpp>
+#include <thread_pool.hpp>
+
+TEST(THREAD_POOL, parallel_for) {
+    oop::thread_pool pool{ 4 };
+    std::vector<int> values(1000, 0);
+
+    pool.parallel_for(values.size(), [&values](size_t i) { values[i] = static_cast<int>(i); });
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST(THREAD_POOL, nested_parallel_for) {
+    oop::thread_pool    pool{ 2 };
+    std::atomic<size_t> count{ 0 };
+
+    pool.parallel_for(8, [&](size_t)
+    {
+        pool.parallel_for(8, [&](size_t) { ++count; });
+    });
+
+    ASSERT_EQ(count, 64);
+}
+
+TEST(THREAD_POOL, exception) {
+    oop::thread_pool pool{ 2 };
+
+    ASSERT_THROW(pool.parallel_for(16, [](size_t i)
+    {
+        if (i == 7)
+        {
+            throw std::runtime_error{ "task failed" };
+        }
+    }), std::runtime_error);
+}
+
+TEST(THREAD_POOL, parallel_for_made_in_order) {
+    oop::thread_pool pool{ 4 };
+    std::vector<size_t> made;
+    std::vector<size_t> values(100, 0);
+
+    pool.parallel_for(values.size(),
+        [&made](size_t i) { made.push_back(i); return i * 2; },
+        [&values](size_t i, size_t arg) { values[i] = arg; });
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        ASSERT_EQ(made[i], i);
+        ASSERT_EQ(values[i], i * 2);
+    }
+
+    ASSERT_THROW(pool.parallel_for(16,
+        [](size_t i)
+        {
+            if (i == 9)
+            {
+                throw std::runtime_error{ "make failed" };
+            }
+            return i;
+        },
+        [](size_t, size_t) {}), std::runtime_error);
+}
+
+TEST(THREAD_POOL, parallel_print_keeps_order) {
+    std::stringstream commands;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const int x = i % 100;
+        const int y = i / 100;
+        const int h = 1 + i % 3;
+        commands << "push " << x << ' ' << y << ' ' << x + 1 << ' ' << y + h << ' '
+                 << x + 2 << ' ' << y << ' ' << x + 1 << ' ' << y - h << '\n';
+    }
+
+    const auto run = [&commands](size_t threads, const std::string& command)
+    {
+        std::stringstream in{ commands.str() + command };
+        std::ostringstream out;
+        auto repl = std::make_unique<oop::basic_repl<1 << 14>>(in, out);
+        repl->set_threads(threads);
+
+        std::string input;
+        while (in >> input)
+        {
+            repl->execute(input);
+        }
+        return out.str();
+    };
+
+    for (const std::string command : { "print", "less 5" })
+    {
+        const std::string serial = run(1, command);
+        ASSERT_GT(serial.size(), 500000);
+        ASSERT_EQ(run(3, command), serial);
+        ASSERT_EQ(run(8, command), serial);
+    }
+}
@@ -0,0 +1,157 @@
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <point.hpp>
+#include <polygon.hpp>
+#include <validation.hpp>
+#include <repl.hpp>
+
+namespace
+{
+    auto constexpr tolerance = 1e-9;
+
+    template <size_t N>
+    basic_polygon<point2d, N> regular(double scale, double phase = 0)
+    {
+        basic_polygon<point2d, N> p;
+        for (size_t i = 0; i < N; ++i)
+        {
+            const double phi = phase + 2 * M_PI * static_cast<double>(i) / N;
+            p[i] = point2d{ { 10 + scale * std::cos(phi), -3 + scale * std::sin(phi) } };
+        }
+        return p;
+    }
+
+    rhombus make_rhombus(double a, double b)
+    {
+        return { point2d{ { a, 0 } }, point2d{ { 0, b } }, point2d{ { -a, 0 } }, point2d{ { 0, -b } } };
+    }
+}
+
+TEST(VALIDATION, rhombus) {
+    using namespace oop::shape_status;
+
+    ASSERT_EQ(oop::polygon_status(make_rhombus(2, 1), tolerance), valid);
+    ASSERT_EQ(oop::polygon_status(make_rhombus(1, 1), tolerance), valid);
+
+    // the four corners of a rectangle are not equilateral
+    const rhombus rectangle{ point2d{ { 0, 0 } }, point2d{ { 2, 0 } }, point2d{ { 2, 1 } }, point2d{ { 0, 1 } } };
+    ASSERT_EQ(oop::polygon_status(rectangle, tolerance), unequal_sides);
+
+    // equal sides used to be enough
+    const rhombus point{};
+    ASSERT_TRUE(oop::polygon_status(point, tolerance) & degenerate);
+
+    const rhombus folded{ point2d{ { 0, 0 } }, point2d{ { 1, 0 } }, point2d{ { 0, 0 } }, point2d{ { 1, 0 } } };
+    ASSERT_TRUE(oop::polygon_status(folded, tolerance) & degenerate);
+}
+
+TEST(VALIDATION, regular_polygons) {
+    using namespace oop::shape_status;
+
+    ASSERT_EQ(oop::polygon_status(regular<5>(3, 0.3), tolerance), valid);
+    ASSERT_EQ(oop::polygon_status(regular<6>(7, 1.1), tolerance), valid);
+
+    // a pentagram has equal sides and equal diagonals but crosses itself
+    auto star = regular<5>(3);
+    star = { star[0], star[2], star[4], star[1], star[3] };
+    ASSERT_TRUE(oop::polygon_status(star, tolerance) & not_convex);
+
+    // moving a vertex along the circle keeps it convex but breaks both lengths
+    auto skewed = regular<6>(7);
+    skewed[1] = point2d{ { 10 + 7 * std::cos(0.8), -3 + 7 * std::sin(0.8) } };
+    ASSERT_EQ(oop::polygon_status(skewed, tolerance), unequal_sides | unequal_angles);
+}
+
+TEST(VALIDATION, batch_matches_single) {
+    std::mt19937 gen{ 11 };
+    std::uniform_real_distribution<double> coordinate{ -10, 10 };
+    std::bernoulli_distribution            random{ 0.3 };
+
+    oop::polygon_batch<6> batch;
+    std::vector<basic_polygon<point2d, 6>> shapes;
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto p = regular<6>(1 + i % 7, i * 0.01);
+        if (random(gen))
+        {
+            p[i % 6] = point2d{ { coordinate(gen), coordinate(gen) } };
+        }
+        shapes.push_back(p);
+        batch.push(p);
+    }
+
+    const auto status = batch.validate(tolerance);
+    ASSERT_EQ(status.size(), shapes.size());
+    size_t invalid = 0;
+    for (size_t i = 0; i < shapes.size(); ++i)
+    {
+        ASSERT_EQ(status[i], oop::polygon_status(shapes[i], tolerance));
+        invalid += status[i] != oop::shape_status::valid;
+    }
+    ASSERT_GT(invalid, 0);
+    ASSERT_LT(invalid, shapes.size());
+}
+
+TEST(VALIDATION, huge_coordinates) {
+    // squaring area and scale overflowed to inf <= inf and flagged these as degenerate
+    const rhombus huge = make_rhombus(2e100, 1e100);
+    ASSERT_EQ(oop::polygon_status(huge, tolerance), oop::shape_status::valid);
+    ASSERT_TRUE(oop::valid_rhombus(huge, tolerance));
+
+    // two shapes take the paired path, the third one the scalar tail
+    oop::polygon_batch<4> batch;
+    batch.push(huge);
+    batch.push(make_rhombus(1e100, 1e100));
+    batch.push(make_rhombus(-3e100, 1e99));
+    for (const auto status : batch.validate(tolerance))
+    {
+        ASSERT_EQ(status, oop::shape_status::valid);
+    }
+}
+
+TEST(VALIDATION, valid_rhombus_matches_status) {
+    std::mt19937 gen{ 5 };
+    std::uniform_real_distribution<double> coordinate{ -10, 10 };
+    std::uniform_real_distribution<double> half{ 0.5, 10 };
+    std::bernoulli_distribution            random{ 0.3 };
+
+    size_t invalid = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto r = make_rhombus(half(gen), half(gen));
+        if (random(gen))
+        {
+            r[i % 4] = point2d{ { coordinate(gen), coordinate(gen) } };
+        }
+        if (i % 50 == 0)
+        {
+            std::swap(r[0], r[1]);
+        }
+        const bool valid = oop::polygon_status(r, tolerance) == oop::shape_status::valid;
+        ASSERT_EQ(oop::valid_rhombus(r, tolerance), valid);
+        invalid += !valid;
+    }
+    ASSERT_GT(invalid, 0);
+}
+
+TEST(VALIDATION, read_rhombus) {
+    rhombus r;
+
+    std::istringstream good{ "2 0 0 1 -2 0 0 -1" };
+    oop::read_rhombus(good, r);
+    ASSERT_FALSE(good.fail());
+
+    std::istringstream degenerate{ "0 0 0 0 0 0 0 0" };
+    oop::read_rhombus(degenerate, r);
+    ASSERT_TRUE(degenerate.fail());
+
+    std::istringstream square{ "0 0 1 0 1 1 0 1.1" };
+    oop::read_rhombus(square, r);
+    ASSERT_TRUE(square.fail());
+}
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    enum command : size_t
+    {
+        push,
+        pop,
+        insert,
+        erase,
+        less,
+        print,
+        commands_count
+    };
+
+    constexpr std::array<const char*, commands_count> command_names = {
+        "push", "pop", "insert", "erase", "less", "print"
+    };
+
+    struct options
+    {
+        unsigned long                         seed      = 1;
+        size_t                                commands  = 100000;
+        std::array<double, commands_count>    mix       = { 40, 25, 10, 10, 10, 5 };
+        double                                invalid   = 0.05;
+        std::string                           size_dist = "uniform";
+        double                                size_mean = 1000;
+        size_t                                phase     = 5000;
+    };
+
+    void usage(const char* name)
+    {
+        std::cerr << "usage: " << name
+            << " [--seed <n>] [--commands <n>] [--mix push=40,pop=25,insert=10,erase=10,less=10,print=5]"
+               " [--invalid <share>] [--size-dist fixed|uniform|exponential] [--size-mean <n>] [--phase <n>]"
+            << std::endl;
+    }
+
+    void parse_mix(const std::string& value, std::array<double, commands_count>& mix)
+    {
+        mix.fill(0);
+        std::istringstream in{ value };
+        std::string        item;
+        while (std::getline(in, item, ','))
+        {
+            const auto eq = item.find('=');
+            if (eq == std::string::npos)
+            {
+                throw std::invalid_argument{ "bad mix item '" + item + "'" };
+            }
+            const std::string name = item.substr(0, eq);
+
+            size_t ix = 0;
+            while (ix < commands_count && name != command_names[ix])
+            {
+                ++ix;
+            }
+            if (ix == commands_count)
+            {
+                throw std::invalid_argument{ "unknown command '" + name + "'" };
+            }
+            mix[ix] = std::stod(item.substr(eq + 1));
+        }
+    }
+
+    class generator
+    {
+    public:
+        explicit generator(const options& opts)
+            : opts_(opts)
+            , gen_(opts.seed)
+            , command_(opts.mix.begin(), opts.mix.end())
+            , grow_({ opts.mix[push], opts.mix[insert] })
+            , shrink_({ opts.mix[pop], opts.mix[erase] })
+        {}
+
+        void run(std::ostream& out)
+        {
+            out << std::setprecision(17);
+            for (size_t i = 0; i < opts_.commands; ++i)
+            {
+                if (i % opts_.phase == 0)
+                {
+                    target_ = next_target();
+                }
+                write(out, next_command());
+            }
+            out << "exit\n";
+        }
+
+    private:
+        command next_command()
+        {
+            const auto c = static_cast<command>(command_(gen_));
+            if (c != push && c != pop && c != insert && c != erase)
+            {
+                return c;
+            }
+
+            // steer mutations towards the current target size
+            if (size_ < target_)
+            {
+                return grow_(gen_) == 0 ? push : insert;
+            }
+            return shrink_(gen_) == 0 ? pop : erase;
+        }
+
+        size_t next_target()
+        {
+            if (opts_.size_dist == "fixed")
+            {
+                return static_cast<size_t>(opts_.size_mean);
+            }
+            if (opts_.size_dist == "exponential")
+            {
+                return static_cast<size_t>(std::exponential_distribution<double>{ 1 / opts_.size_mean }(gen_));
+            }
+            return static_cast<size_t>(std::uniform_real_distribution<double>{ 0, 2 * opts_.size_mean }(gen_));
+        }
+
+        size_t index(size_t bound)
+        {
+            return std::uniform_int_distribution<size_t>{ 0, bound }(gen_);
+        }
+
+        void write(std::ostream& out, command c)
+        {
+            out << command_names[c];
+            switch (c)
+            {
+            case push:
+                write_rhombus(out);
+                break;
+            case pop:
+                size_ -= size_ > 0;
+                break;
+            case insert:
+                out << ' ' << index(size_);
+                write_rhombus(out);
+                break;
+            case erase:
+                out << ' ' << index(size_ > 0 ? size_ - 1 : 0);
+                size_ -= size_ > 0;
+                break;
+            case less:
+                out << ' ' << std::uniform_real_distribution<double>{ 0, 2 * max_half_diagonal * max_half_diagonal }(gen_);
+                break;
+            default:
+                break;
+            }
+            out << '\n';
+        }
+
+        /*!
+         * @brief rhombus from a random center and two perpendicular half-diagonals
+         */
+        void write_rhombus(std::ostream& out)
+        {
+            std::uniform_real_distribution<double> coord{ -1000, 1000 };
+            std::uniform_real_distribution<double> length{ 0.5, max_half_diagonal };
+            std::uniform_real_distribution<double> angle{ 0, 2 * M_PI };
+
+            const double cx = coord(gen_);
+            const double cy = coord(gen_);
+            const double phi = angle(gen_);
+            const double a = length(gen_);
+            const double b = length(gen_);
+
+            double xs[4] = { cx + a * std::cos(phi), cx - b * std::sin(phi), cx - a * std::cos(phi), cx + b * std::sin(phi) };
+            double ys[4] = { cy + a * std::sin(phi), cy + b * std::cos(phi), cy - a * std::sin(phi), cy - b * std::cos(phi) };
+
+            if (std::bernoulli_distribution{ opts_.invalid }(gen_))
+            {
+                xs[0] += a;
+            }
+            else
+            {
+                ++size_;
+            }
+
+            for (size_t i = 0; i < 4; ++i)
+            {
+                out << ' ' << xs[i] << ' ' << ys[i];
+            }
+        }
+
+        static constexpr double max_half_diagonal = 50;
+
+        options                                 opts_;
+        std::mt19937_64                         gen_;
+        std::discrete_distribution<size_t>      command_;
+        std::discrete_distribution<size_t>      grow_;
+        std::discrete_distribution<size_t>      shrink_;
+        size_t                                  size_   = 0;
+        size_t                                  target_ = 0;
+    };
+}
+
+int main(const int argc, char* argv[])
+{
+    options opts;
+    try {
+        for (int i = 1; i < argc; ++i)
+        {
+            if (i + 1 >= argc)
+            {
+                usage(argv[0]);
+                return 1;
+            }
+            const char* value = argv[++i];
+            if (std::strcmp(argv[i - 1], "--seed") == 0)
+            {
+                opts.seed = std::stoul(value);
+            }
+            else if (std::strcmp(argv[i - 1], "--commands") == 0)
+            {
+                opts.commands = std::stoul(value);
+            }
+            else if (std::strcmp(argv[i - 1], "--mix") == 0)
+            {
+                parse_mix(value, opts.mix);
+            }
+            else if (std::strcmp(argv[i - 1], "--invalid") == 0)
+            {
+                opts.invalid = std::stod(value);
+            }
+            else if (std::strcmp(argv[i - 1], "--size-dist") == 0)
+            {
+                opts.size_dist = value;
+            }
+            else if (std::strcmp(argv[i - 1], "--size-mean") == 0)
+            {
+                opts.size_mean = std::stod(value);
+            }
+            else if (std::strcmp(argv[i - 1], "--phase") == 0)
+            {
+                opts.phase = std::max<size_t>(1, std::stoul(value));
+            }
+            else
+            {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);
+    generator{ opts }.run(std::cout);
+}
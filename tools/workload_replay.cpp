@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <repl.hpp>
+
+namespace
+{
+    /*!
+     * @brief output sink that only counts written bytes
+     */
+    class counting_buffer : public std::streambuf
+    {
+    public:
+        [[nodiscard]] size_t written() const noexcept
+        {
+            return written_;
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            ++written_;
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char*, std::streamsize n) override
+        {
+            written_ += static_cast<size_t>(n);
+            return n;
+        }
+
+    private:
+        size_t written_ = 0;
+    };
+
+    double percentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty())
+        {
+            return 0;
+        }
+        const auto ix = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(ix, sorted.size() - 1)];
+    }
+
+    void report_row(std::ostream& out, const std::string& name, std::vector<double>& latencies)
+    {
+        std::sort(latencies.begin(), latencies.end());
+        out << std::left << std::setw(10) << name << std::right
+            << std::setw(10) << latencies.size()
+            << std::setw(12) << percentile(latencies, 0.5)
+            << std::setw(12) << percentile(latencies, 0.99)
+            << std::setw(12) << percentile(latencies, 0.999)
+            << std::setw(12) << (latencies.empty() ? 0 : latencies.back())
+            << '\n';
+    }
+
+    // the application's pool size, generated workloads stay well below it by default
+    auto constexpr pool_size = OOP_POOL_SIZE;
+}
+
+int main(const int argc, char* argv[])
+{
+    if (argc > 2)
+    {
+        std::cerr << "usage: " << argv[0] << " [<workload file>]" << std::endl;
+        return 1;
+    }
+
+    std::ostringstream text;
+    if (argc == 2)
+    {
+        std::ifstream file{ argv[1] };
+        if (!file)
+        {
+            std::cerr << "error: can not open " << argv[1] << std::endl;
+            return 1;
+        }
+        text << file.rdbuf();
+    }
+    else
+    {
+        text << std::cin.rdbuf();
+    }
+
+    std::istringstream in{ text.str() };
+    counting_buffer    sink;
+    std::ostream       out{ &sink };
+
+    auto repl = std::make_unique<oop::basic_repl<pool_size>>(in, out);
+
+    using clock = std::chrono::steady_clock;
+    std::map<std::string, std::vector<double>> latencies;
+    std::vector<double>                        all;
+
+    const auto  start = clock::now();
+    std::string command;
+    while (in >> command)
+    {
+        const auto t0 = clock::now();
+        const bool go = repl->execute(command);
+        const auto t1 = clock::now();
+
+        const double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        latencies[command].push_back(us);
+        all.push_back(us);
+        if (!go)
+        {
+            break;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::cout << std::fixed << std::setprecision(3)
+        << "commands:    " << all.size() << '\n'
+        << "time:        " << seconds << " s\n"
+        << "throughput:  " << (seconds > 0 ? static_cast<double>(all.size()) / seconds : 0) << " cmd/s\n"
+        << "output:      " << sink.written() << " bytes\n"
+        << "final size:  " << repl->get_queue().size() << '\n'
+        << "peak rss:    " << usage.ru_maxrss << " KiB\n\n"
+        << std::left << std::setw(10) << "command" << std::right
+        << std::setw(10) << "count"
+        << std::setw(12) << "p50 us"
+        << std::setw(12) << "p99 us"
+        << std::setw(12) << "p999 us"
+        << std::setw(12) << "max us"
+        << '\n';
+    for (auto& [name, values] : latencies)
+    {
+        report_row(std::cout, name, values);
+    }
+    report_row(std::cout, "all", all);
+}